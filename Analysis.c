@@ -6,8 +6,8 @@ Ranking should meet the following conditions:
 - being a neighbor is a reflexive relationship
 - only two object from the considered set have only one neighbor
 
-There are multiple linear ordering methods like:
-- standardized sum method (used in this program)
+There are multiple linear ordering methods like (all of them are available in this program, see \ref methods):
+- standardized sum method (used by default)
 - Hellwig method
 - TOPSIS method
 - rank method
@@ -26,26 +26,170 @@ The program prompts the user to reference files that have the names of observati
 - various files have been entered
 - the data from the files are compatible with each other
 
-Data from files are saved into arrays. Line breaks (needed for transparent printing to a file) are removed.
+Data from files are saved into a dataset (see \ref storage). Line breaks (needed for transparent printing to a file) are removed.
 Then the program informs the user about the necessity to enter the value of the coefficient of variation. Depending on the value, the output file will contain information about the required removal of the variable (not necessary).
 The program will ask the user to enter the name of the output file.
 If the data has been prepared correctly, the program will display the message "Completed. Results stored in (file_name) file" and save the results to a file.
 
+\subsection compilation Compilation
+The program uses POSIX memory mapping and threads, it can be compiled together with the library (see \ref library) e.g. with: gcc -O2 -march=native -pthread Analysis.c aoimo.c -o Analysis -lm
+
+\subsection library Library
+The computation is done by the aoimo library (aoimo.h and aoimo.c), this file only reads the options, prompts the user, writes the results files and reports errors. The library can be built separately e.g. with: gcc -c -O2 -march=native -fPIC aoimo.c && ar rcs libaoimo.a aoimo.o
+- the library has no global variables, all state is kept in the dataset (see dataset_create(), load_dataset(), dataset_from_arrays()), the buffers of a computation (see computation_reserve()) and an optional pool of threads, so other programs can rank many datasets in one process, also from different threads
+- the functions of the library do not print anything and do not end the program, errors are returned as codes (see aoimo_error_code) and their details are stored in an aoimo_error structure, the messages listed in \ref err are printed by this program
+- compute_ranking() fills the buffers provided by the caller: statistics of variables, index values and the ordered ranking
+
+\subsection options Command line options
+- --top K - only the first K positions of the ranking are written to the results file
+- --threads N - statistics, scaling and scoring are computed by N threads (0 - one thread per processor), the ranking does not depend on the number of threads
+- --convert FILE - the dataset read from the observation, variable and data files is stored in the binary cache FILE (see \ref cache) and the program ends
+- --cache FILE - the dataset is read from the binary cache FILE instead of the observation, variable and data files
+- --table FILE - the dataset is read from the CSV or TSV FILE (see \ref table) instead of the observation, variable and data files, it can be stored in a binary cache with --convert
+- --groups FILE - the observations are also ranked within the groups given in the group FILE (see \ref groups), the ranking of every group is written after the global rankings, it can be used only with the text format of the results file
+- --settings FILE - the direction and weight of every variable are read from the settings FILE (see \ref settings), otherwise all variables are stimulants with equal weights, it cannot be used with --bootstrap, --jackknife and --updates
+- --batch FILE - the jobs listed in the manifest FILE (see \ref batch) are computed without any questions to the user
+- --jobs N - with --batch, N jobs are computed at the same time (every job still uses the number of threads given by --threads)
+- --serve SOCKET - the program runs as a server listening on the Unix SOCKET and answers ranking requests (see \ref server) until the request quit comes, --threads, --top, --method and --format apply to all requests; clients are served one at a time, so a client waits until the previous ones disconnect (an idle client is disconnected after SERVER_TIMEOUT seconds)
+- --entries N - with --serve, at most N datasets are kept in memory (4 by default)
+- --send SOCKET - every line of the standard input is sent as a request to the server listening on the Unix SOCKET and its reply is printed
+- --method LIST - the ranking is computed with the methods from the comma-separated LIST: sum, hellwig, topsis, rank (see \ref methods), the default is sum
+- --bootstrap B - the stability of the ranking is assessed with B bootstrap replicates (see \ref resampling)
+- --jackknife - the stability of the ranking is assessed with observation_number jackknife replicates, every one without a single observation
+- --resample-variables - with --bootstrap, variables are also drawn with replacement in every replicate
+- --seed S - a seed of random numbers of --bootstrap (0 by default), the same seed gives the same results for any number of threads
+- --sensitivity FILE - the rank-shift matrix of the leave-one-variable-out analysis is written to FILE (see \ref sensitivity)
+- --updates FILE - the ranking is computed incrementally and kept up to date while the changes listed in FILE (see \ref updates) are applied
+- --stream - the ranking of the standardized sum method is computed from the files without keeping the dataset in memory (see \ref stream), only --top can be used with it
+- --generate PREFIX - a dataset of random values is written into the files PREFIXObs.txt, PREFIXVar.txt and PREFIXData.txt (see \ref benchmark) and the program ends
+- --shape NxM - with --generate, the dataset has N observations and M variables (1000x5 by default)
+- --distribution NAME - with --generate, the values are drawn from the distribution NAME: uniform, normal, lognormal or ties (uniform by default), --seed gives the seed of random numbers
+- --benchmark FILE - every phase of the ranking is timed separately and the timings are written into FILE in the JSON format (see \ref benchmark), only --threads, --top, --repeat and --updates can be used with it; with --updates every refresh is timed and compared with a complete computation (see \ref updates)
+- --repeat R - with --benchmark, the phases are timed R times (1 by default)
+- --format NAME - the results file is written in the format NAME: text (the report described in \ref files, by default), csv or binary (see \ref output), it cannot be used with --updates, --stream, --bootstrap and --jackknife
+- --metrics FILE - the time, bytes read and written, parsed values and peak memory of every phase of the ranking are written into FILE in the JSON format, or as a summary into the standard error stream if FILE is - (see \ref metrics)
+- --scaling - before the results are computed, the statistics, scaling and scoring are timed with 1, 2, 4, ... up to the number of threads given by --threads and the time, speedup and whether the ranking is identical to the one computed by a single thread are printed
+
 \subsection files Files
 The observation file contains the names of observations that the user enters into the program.
 The variable file contains the names of variables that the user enters into the program.
-The data file contains numerical data that the user enters into the program (all already changed to stimulants).
+The data file contains numerical data that the user enters into the program (stimulants, unless the directions of variables are given with --settings, see \ref settings).
 
 It is important that the number of observations * number of the variables is equal to the number of data. Otherwise, the program will inform user about an error while downloading data.
 
+\subsection output Results file formats
+The results file has a buffer of OUTPUT_BUFFER bytes and positions of rankings are written without fprintf(): index values are converted by format_value(), which gives the same text as printf("%f") with integer arithmetic (values very close to the half of the last decimal place and large values are passed to snprintf()), and a whole line is written at once.
+- text - the statistics of variables followed by the rankings, a line "position. index - name" for every position
+- csv - only the rankings: a header line method,position,index,observation_id,observation and a line for every position of every method, names containing a comma, a quote or a line break are quoted
+- binary - a header of 24 bytes (the text AOIMORNK, a byte order mark 0x01020304, the format version, the number of rankings and the number of positions of every ranking as 32-bit integers) followed by a record of 16 bytes for every position: the index value as a 64-bit floating point number, the observation ID (the line of the observation file from 0) and the method (0 - sum, 1 - Hellwig, 2 - TOPSIS, 3 - rank) as 32-bit integers, in the byte order of the machine
+
+The binary format does not need the names of observations and keeps the exact index values, so it is the fastest to write and to load.
+
+\subsection storage Data storage
+The dataset is allocated on the heap once the number of observations and variables is known, so its size is limited by the available memory and not by the stack.
+Values are stored column-major (variable by variable), in the same order as in the data file, therefore the data file is read straight into the dataset and every variable occupies a contiguous block of memory.
+The median and other quantiles are computed on a copy of a single variable, so only one copy of the whole dataset is kept in memory.
+Names of observations and variables are kept in tables of names (see string_table): the observation and variable files are mapped into memory and copied into a single arena at once with line breaks replaced by zero bytes, names of any length are kept whole and the rankings refer to them only by observation IDs. With --stream the names are not copied at all: the runs refer to them by their offsets in the observation file, which is split into lines in the same way (see \ref stream).
+
+\subsection table Table files
+With --table the dataset is read from a single CSV or TSV file instead of three files. The first row is a header: the name of the observation column followed by the names of variables, every other row holds the name of an observation followed by its values, e.g.:
+
+    Country,GDP,Exports
+    Poland,1.5,2.5
+    "Czech Republic, The",1.25,3
+
+The separator is a tab if the header contains one, otherwise a comma. Fields may be quoted with " (a quote inside is written as ""), but may not contain line breaks. Spaces around values and empty rows are skipped.
+The number of observations is the number of rows and the number of variables comes from the header, so instead of comparing the number of data with observations*variables every row is checked to have exactly one value per variable (see FIELD ERROR in \ref err). The position of an incorrect value in DATA FORMAT ERROR is counted row by row.
+load_table() maps the file, splits it into chunks which end at line breaks and parses the chunks with the pool of threads given by --threads: the first pass counts the rows of every chunk, so every chunk knows its first observation, and the second pass writes the values straight into the columns of the dataset.
+
+\subsection groups Grouped rankings
+With --groups the observations are ranked with the standardized sum method not only globally, but also within groups (e.g. regions or product lines), without splitting the dataset into a dataset per group. The group file has the key of the group of every observation, one per line in the order of the observation file (like the observation file), observations with equal keys are in the same group and groups are written in the order of their first observation.
+Every group has its own mean and standard deviation of every variable, its own scaling and the index values normalized by ranking_f_index() with the minimum and maximum of the group. compute_groups() finds the statistics of all groups with a single scan of every column (variables are scanned in parallel) and then scales, scores and ranks the groups in parallel. It reads the values before compute_ranking() scales them in place. --top limits every ranking of a group.
+
+\subsection settings Directions and weights of variables
+Without --settings the data file has to contain stimulants only and every variable has the same weight. With --settings FILE the settings file has a line for every variable, in the order of the variable file:
+
+    stimulant
+    destimulant 2
+    nominant 36.6 0.5
+
+A destimulant is negated and a nominant value x is converted to -|x-TARGET|. The optional last number is the weight (1 by default), it has to be positive (a variable with the weight 0 would be scaled to 0 for all observations, so it would still change the ranks of the rank method), weights are normalized to the mean of 1, so the mean value of an observation is the weighted mean of its scaled values.
+The values in the dataset are not converted before the computation: the statistics in the results file describe the values from the data file and the conversion and the weight are applied by compute_ranking() in the same pass which scales a variable (the scaled value is multiplied by -weight/standard deviation for a destimulant), so no copy of the dataset is made. Only a nominant needs an extra read of its column for the mean and standard deviation of the converted values. The results file lists the directions and normalized weights after the statistics.
+The Hellwig and TOPSIS methods use the best and worst converted values as the pattern and the ideal and anti-ideal solutions and weighted distances, the rank method uses the converted values but not the weights, so its mean ranks stay exact. The group rankings of --groups use the settings as well.
+
+\subsection batch Batch mode
+In the batch mode (--batch) the program reads a manifest file with one job in every line: the names of the observation file, the variable file, the data file, the minimal coefficient of variation and the results file, separated with spaces or tabs. Empty lines and lines starting with # are skipped. A job in an incorrect format is reported as MANIFEST ERROR before any job is computed.
+All jobs are computed in a single process. Every job worker keeps its dataset and buffers for the next job and only enlarges them when a bigger dataset comes, so memory is not allocated again for every job. An error in the files of a job (e.g. DATA ERROR) is reported with the line number of the job, the other jobs are still computed and the program ends with the exit status 1.
+
+\subsection server Server mode
+In the server mode (--serve) the program listens on a Unix socket and answers requests sent by clients (e.g. the program started with --send). A request is a line in the format of a job of the manifest file (see \ref batch) and the reply is a single line: OK, whether the dataset was loaded or taken from memory (cached), the time of the request and the name of the results file, or ERROR with the name of the error. The details of errors are printed by the server. The request quit stops the server.
+The server keeps the last used datasets with their statistics of variables and rankings in memory. A dataset is found first by the device, inode, size and modification time (in nanoseconds) of its observation, variable and data files, so a request with files that did not change costs a stat() of every file and the results file written for the minimal coefficient of variation of the request. Only if the files are not known in this way they are hashed (see file_hash()), so a copy of a known file or a file which was touched but not changed is not read and parsed again either. When --entries datasets are kept, the least recently used one is replaced.
+Clients are served one at a time by a single thread (the pool of threads computes the rankings), so a request waits until the previous clients disconnect. A client which sends no request or does not read its reply for SERVER_TIMEOUT seconds is disconnected, so an idle client cannot stop the server for longer.
+
+\subsection updates Incremental updates
+With --updates the ranking is kept by an incremental ranking of the library (see incremental_refresh()) and the changes from the updates file are applied one line at a time:
+- insert V1 ... Vm NAME - a new observation NAME with the values of all m variables
+- update V1 ... Vm NAME - new values of the observation NAME
+- delete NAME - the observation NAME is removed
+- refresh FILE - the results with the changes applied so far are written to FILE
+
+The name of an observation is the rest of the line, so it may contain spaces, empty lines and lines starting with # are skipped. After the last change the results are written to the results file.
+The incremental ranking keeps running sums and sums of squares of every variable, so the mean, standard deviation, variance and coefficient of variation are brought up to date without a pass over the dataset, and the values of every variable are kept sorted (a changed value is moved with a binary search and a single memmove()), so the minimum, maximum and quantiles are read directly; after more than SORTED_CHANGES changes between two refreshes the variables are sorted again instead. Changed rows are scored again (a single multiply-add per value, the dataset is not scaled in place), the scores of the other rows are only corrected for the variables whose standard deviations changed, and the previous ranking is repaired by insertion sort, since small changes move observations only by a few positions. The sums are computed again from the values after every observation_number changes, so rounding errors do not accumulate. Index values are equal to the ones of a complete computation up to rounding errors.
+An update of k values of an observation changes the standard deviations of k variables, so a refresh after it costs O(observation_number*k). An insertion or a deletion changes the standard deviations of all variables, so the scores of all rows are computed again in O(observation_number*variables_number) like in a complete computation, and only the statistics, quantiles and the sorting of the ranking are saved.
+With --benchmark FILE every refresh is timed and followed by a complete computation (compute_ranking()) of the same values, which is timed too; the JSON file contains the number of observations, variables, threads and refreshes, the minimal and mean time of the incremental and the complete computation, the speedup (the total time of complete computations divided by the total time of refreshes) and the number of compared positions and of positions with the same observation in both rankings.
+
+\subsection cache Binary dataset cache
+A dataset which is ranked many times can be converted once (--convert) into a binary cache file, which is then mapped into memory (--cache) without parsing. The file consists of:
+- a header of 64 bytes: the text AOIMOBIN, a byte order mark, a format version, the number of observations and variables, the offset and size of the name table and the offset of values
+- the name table: names of observations and then of variables, each ended with a zero byte
+- values as 64-bit floating point numbers, variable by variable (column-major, the same layout as the dataset in memory), the block starts at an offset aligned to 64 bytes
+
+The values of the dataset stay in the mapped file (a private mapping, so scaling does not modify the file), only the names are copied. A file written on a machine with a different byte order or by an incompatible version is reported as CACHE FORMAT ERROR.
+
+\subsection stream Out-of-core streaming
+With --stream the dataset is never loaded into memory, so the data file may be larger than the available memory. The files are read in two passes by the library (see stream_open() and stream_rank()):
+- the first pass reads the data file once in chunks of STREAM_CHUNK bytes and checks it like load_data(); the values of a variable are merged in blocks into the minimum, maximum, mean and sum of squared deviations exactly like by f_statistics(), and the offset of the first value of every block of STREAM_BLOCK observations of every variable is remembered
+- the second pass reads every block of observations variable by variable from the remembered offsets, scales the values and computes the mean values; every block is sorted and written as a run (index value, ID and the offset of the name of every observation in the observation file) into a temporary file, then the runs are merged, up to STREAM_FAN_IN at a time, so the ranking is written from the best to the worst position in a single sequential pass; names are read from the mapped observation file only when their positions are written, so they can be of any length
+
+The median, quartiles and deciles cannot be selected without keeping the variable in memory, so they are approximated by a mergeable quantile sketch (see quantile_sketch_add()) of every variable and are labeled approximate in the results file; they are exact for a variable with at most STREAM_SKETCH_CAPACITY values. The mean, standard deviation, variance, coefficient of variation, minimum, maximum and the ranking are the same as without --stream.
+The memory used does not depend on the number of observations, apart from one offset for every block of STREAM_BLOCK observations of every variable. The temporary files are created by tmpfile() and need 24 bytes per observation.
+
+\subsection benchmark Benchmark
+--generate writes a synthetic dataset for measurements. The same shape, distribution and seed always give the same files, since the values are drawn from the splitmix64 generator of the library (see next_random()):
+- uniform - values from the range [0,100)
+- normal - values with the mean 50 and the standard deviation 10 (Box-Muller transform)
+- lognormal - exponents of values of the standard normal distribution, a skewed distribution
+- ties - integer values from 1 to 10, so most values are equal to many others
+
+--benchmark computes the ranking of the standardized sum method like the interactive mode (the user is prompted for the same files) but times every phase separately: load (counting, parsing and storing the values by load_dataset()), statistics (f_statistics()), quantiles (f_distribution()), scaling (compute_scaling()), ranking (compute_method(), mean and index values and the order) and output (writing the results file). The phases run as separate passes over the dataset on the pool of --threads threads, while compute_ranking() does statistics, quantiles and scaling of a variable in a single task, so the sum of the phases may be slightly higher than the time of compute_ranking().
+With --repeat the whole computation (also reading the files) is repeated and the minimal and mean time of every phase are written. The JSON file contains the number of observations, variables and threads, the number of repetitions, the minimal and mean time of every phase and of all phases in seconds and a checksum of the ranking (FNV-1a of the index values and observation IDs of all positions), so the timings of two versions of the program are compared only if the checksums are equal. A results file is written in every repetition, so the output phase measures the real writer.
+
+\subsection metrics Metrics of phases
+With --metrics every run of the program records the metrics of the phases of the ranking, so a long run can be explained without a profiler:
+- load - reading the observation, variable and data files (or mapping the binary cache file), the bytes read are the sizes of the files and the values are the number of parsed values (the number of values stored in the cache file for --cache, so the throughput of both loaders can be compared)
+- statistics - descriptive statistics and quantiles of all variables
+- scaling - scaling of all variables
+- scoring - mean and index values of observations
+- sort - the order of the ranking
+- output - writing the results file (all rankings of --method and the percentiles of --bootstrap or --jackknife), the bytes written are the size of the results file
+
+The time is the wall time in seconds and the peak memory is the maximal resident memory of the process at the end of the phase (getrusage()). compute_ranking() does statistics, quantiles and scaling of a variable in a single task, with --metrics these steps are done as separate passes instead, which gives the same results. The JSON file contains the number of observations and variables, an array of phases with their name, seconds, bytes_read, bytes_written, values_parsed and peak_memory_kb, and total_seconds.
+
 \subsection no_data Determining the number of variables, observations and data
 The number of particular parameters was obtained by incrementing the declared variable while reading the newline mark.
+The data file is mapped into memory and read once by load_data(): values are counted and parsed in the same pass (a hand-written parser handles plain decimal numbers, other forms such as hexadecimal numbers are passed to strtod()) and written directly into the dataset. The number of data is the number of values, an empty row is counted as a position with an incorrect value and a line break at the end of the file is allowed.
 
 \subsection statistics Descriptive statistics
+Minimum, maximum, mean, standard deviation, variance and coefficient of variation of a variable are computed together by f_statistics() in a single pass over the column.
+The column is processed in blocks small enough to stay in the cache: every block is summed and compared (minimum, maximum), then the squared deviations from the block mean are summed, and the block results are merged into the running mean and sum of squared deviations (the pairwise formula of Chan et al.), which is numerically stable also for large values with a small spread.
+The inner loops are vectorized with AVX or SSE2 when the compiler targets them (e.g. -march=native), otherwise plain C loops are used.
 - Minimal value: determined by comparing the values ​​for individual columns, the declared variable is overwritten if a lower value is found
 - Maximal value: determined by comparing the values ​​for individual columns, the declared variable is overwritten when a higher value is found
 - Mean value: calculated by summing all values ​​for the given column and dividing by the total number of observations
-- Median value: calculated on the basis of a sorted data array, in the case of an even number of observations the mean of the middle 2 values, in the case of an odd number of observations the middle value
+- Median value: in the case of an even number of observations the mean of the middle 2 values, in the case of an odd number of observations the middle value
+- Quartiles, interquartile range and deciles: the quantile of order p is interpolated linearly between the values at positions floor((n-1)p) and floor((n-1)p)+1 of the ordered variable (the median is the quantile of order 0.5)
+
+The values needed for all quantiles are found at once by f_quantiles() with a selection algorithm (a multi-quickselect with median of three pivots and three-way partitioning), which puts the chosen positions in their sorted place without sorting the whole column, in expected linear time. A range that is partitioned too many times is sorted with qsort(), so the worst case is O(n log n).
 - Standard deviation value: rooted quotient of the square of the sum of differences of individual values ​​of a given variable with the mean value of the variable and the number of variables
 - Variance: the square value of the standard deviation
 - Coefficient of variation: the absolute value of the quotient of the variable's standard deviation and the mean values ​​of the variable presented as percentages
@@ -53,465 +197,1939 @@ The number of particular parameters was obtained by incrementing the declared va
 \subsection scaling Scaling variables
 Scaling is done by taking the value and subtracting the mean value of the variable and dividing the obtained value by the variable's standard deviation.
 
+\subsection threads Parallel computation
+compute_ranking() runs the work on a thread pool (the calling thread also takes part in it). Every variable is a separate task (statistics, quantiles and scaling of the column, every thread has its own buffer for the copy of the variable), observations are split into blocks of ROW_BLOCK rows for the mean and index values. Every value is computed by exactly the same operations in the same order as with a single thread, so the results are bit-identical for any number of threads.
+
 \subsection rankings Create rankings
-- Mean value: calculated by summing all values ​​for a given row and dividing by the total number of variables
+- Mean value: calculated by summing all values ​​for a given row and dividing by the total number of variables, the values are added variable by variable for a block of rows, so each column is read contiguously
 - Minimum value: determined by comparing the value of an array of the mean value of each observation
 - Maximum value: determined by comparing the value of an array of the mean value of each observation
 - Index value: calculated by the quotient between the difference of the mean and the minimum value and the difference between the maximum and minimum value, the range of values ​​[0,1]
+- Ranking: pairs of an index value and an observation ID are sorted by ranking_order() from the highest to the lowest index value (observations with equal values keep the order of the observation file), names of observations are never moved. The whole ranking is sorted with qsort() in O(n log n); with the --top K option only the best K pairs are kept in a bounded heap, in O(n log K)
+
+\subsection methods Linear ordering methods
+All methods work on the same dataset scaled by compute_ranking(), so with several methods (--method) the data are read and scaled only once and every method only computes its own index values and ranking with compute_method(). The statistics of variables are written once, followed by a ranking for every method.
+- Standardized sum method: see \ref rankings
+- Hellwig method: the pattern of development is the maximal scaled value of every variable, the Euclidean distance of every observation to the pattern is computed and the index value is 1-d/d0, where d0 is the mean distance plus twice the standard deviation of distances
+- TOPSIS method: the ideal solution is the maximal and the anti-ideal solution the minimal scaled value of every variable, the index value is the distance to the anti-ideal solution divided by the sum of the distances to the ideal and the anti-ideal solution
+- Rank method: every variable is sorted once (qsort(), so O(n log n) per variable), observations get ranks from 1 for the lowest value (equal values get the mean of their ranks), the mean ranks of observations are standardized like the mean values of the standardized sum method
+
+The distances are computed variable by variable for blocks of ROW_BLOCK observations, so every variable is read contiguously, and the inner loop is vectorized with AVX or SSE2 like the descriptive statistics. Blocks (and variables for the rank method) are computed by the thread pool and the results do not depend on the number of threads.
+With --updates only the standardized sum method is used.
+
+\subsection resampling Stability of the ranking
+With --bootstrap or --jackknife the replicates are computed by ranking_resample() in memory, without reading the files again. In a bootstrap replicate observation_number observations are drawn with replacement (and, with --resample-variables, variables too), a jackknife replicate leaves out one observation. The means and standard deviations of variables are computed from the drawn observations, all observations are scaled with them and ranked by the standardized sum method, so every observation gets a position in every replicate.
+Replicates are computed in parallel by the thread pool, every thread keeps its own buffers (weights of observations and variables, scores and the ranking) for all its replicates, and every replicate draws from its own stream of random numbers, so the results do not depend on the number of threads.
+The results file ends with the 5%, 25%, 50%, 75% and 95% percentiles of the position of every observation (observations in the order of the observation file). The positions of all replicates are kept in memory (observation_number*replicates integers).
+
+\subsection sensitivity Sensitivity to variables
+With --sensitivity the program checks how the ranking of the standardized sum method changes when a single variable is left out, e.g. one with the note about a low coefficient of variation. Scaling of a variable does not depend on other variables, so ranking_sensitivity() gets the score of an observation without the variable j by subtracting its scaled value of the variable j from the sum of its scaled values, instead of computing the ranking again for every variable. Every variable then needs only one sort of the scores (variables are sorted in parallel by the thread pool).
+The file starts with a header: Observation, Position and the names of variables (variables with a coefficient of variation lower than the minimal one are marked with *), it is followed by a line for every observation in the order of the ranking: its name, its position and the change of the position without every variable (positive if the observation moves down, negative if it moves up). Columns are separated by tabs.
 
 \subsection err Error handlers
-- File existence - checks if the pointer is NULL, if so, it reports an EXISTENCE ERROR error
+- File existence - checks if the pointer is NULL, if so, it reports an EXISTENCE ERROR error (also when a temporary file of --stream cannot be created or written)
 - File incorrect - checks if the user tried to enter the same file twice, if so, it informs about a DUPLICATE FILE ERROR error
 - Data incorrect - makes the number of variables * number of observations different, if so, it informs about the DATA ERROR error
 - Empty file - checks if a given file is empty, if so, it informs about EMPTY FILE ERROR
+- Memory - checks if the dataset could be allocated, if not, it informs about MEMORY ERROR
+- Cache file - checks if the header of a binary cache file is correct and the file is complete, if not, it informs about CACHE FORMAT ERROR
 - Correctness of data: checks if data is not a number, if so, it informs about the DATA FORMAT ERROR error
+- Groups: checks if the group file given by --groups has a key for every observation, if not, it informs about the GROUP ERROR error
+- Settings of variables: checks if the settings file given by --settings has a correct line for every variable with a positive weight, if not, it informs about the SETTINGS ERROR error with the line number
+- Fields of a table file: checks if every row of the table file given by --table has as many values as the header has variables, if not, it informs about the FIELD ERROR error with the line number of the first incorrect row
+- Command line options: checks if an option is known and has a correct value, if not, it informs about the OPTION ERROR error
+- Manifest: checks if every job in the manifest file has 4 file names and a non-negative coefficient of variation, if not, it informs about the MANIFEST ERROR error with the line number, an error of a single job (e.g. a missing file) is reported with the line number of the job and the other jobs are still computed
+- Updates: checks if every change in the updates file is known, has values of all variables and refers to an existing observation, if not, it informs about the UPDATES ERROR error with the line number
 - Correctness of the coefficient of variation: checks if the coefficient is not a number, if so, it informs about the DATA FORMAT ERROR error and if the coefficient takes a negative value, if so, it informs about the RANGE ERROR error
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <signal.h>
+
+#include "aoimo.h"
 
 /**
-A macro, which is the association of an identifier or parameterized identifier with a token string.
+A macro, which is the number of percentiles of positions of an observation written by write_stability().
 */
-#define MEMORY 102
+#define STABILITY_PERCENTILES 5
 
 /**
-An integer number of observations counted by function counter().
+A macro, which is the number of phases timed by run_benchmark(): load, statistics, quantiles, scaling, ranking and output.
 */
-int observation_number;
+#define BENCHMARK_PHASES 6
 
 /**
-An integer number of variables counted by function counter().
+A macro, which is the number of distributions of values written by generate_dataset().
 */
-int variables_number;
+#define DISTRIBUTIONS 4
 
 /**
-An integer number of data counted by function counter().
+A macro, which is the size in bytes of the buffer of a results file.
 */
-int data_number;
+#define OUTPUT_BUFFER (1<<20)
 
 /**
-A function that takes a parameter and returns the number of positions in a chosen file or error generated by errhl_no_data().
-\param *file - a pointer to a FILE structure
+A macro, which is the number of seconds the server waits for a request or for sending a reply before it closes the connection of a client.
 */
-int counter(FILE *file);
+#define SERVER_TIMEOUT 10
 
 /**
-An error handler that takes a parameter and returns an error when file does not exist.
-\param *file - a pointer to a FILE structure
+A macro, which is the maximal length of a value written by format_value() with the terminating zero byte.
 */
-void errhl_file_exist(FILE*file);
+#define FORMAT_LENGTH 320
 
 /**
-An error handler that takes 2 parameters and returns an error when tried to open the same file twice.
-\param *file_name - a pointer to a first file name provided
-\param *file_name2 - a pointer to a second file name provided
+A macro, which is the version of the format of binary results files.
 */
-void errhl_incorrect_file(char *file_name, char *file_name2);
+#define RESULTS_VERSION 1
 
 /**
-An error handler that returns an error when number of data does not match number of observations and variables.
+A macro, which is the number of phases of a ranking measured with --metrics: load, statistics, scaling, scoring, sort and output.
 */
-void errhl_incorrect_data();
+#define METRICS_PHASES 6
 
 /**
-An error handler that returns an error when file is empty.
+A structure that stores options provided in the command line.
 */
-void errhl_no_data();
+typedef struct options{
+    int top; /**< number of positions of the ranking written to the results file, 0 for all */
+    int threads; /**< number of threads used for the computation */
+    int scaling; /**< 1 if the speedup for different numbers of threads has to be reported, otherwise 0 */
+    char *cache; /**< name of the binary cache file to read the dataset from, NULL for text files */
+    char *convert; /**< name of the binary cache file to write the dataset to, NULL for a ranking */
+    char *table; /**< name of the CSV or TSV table file to read the dataset from, NULL for the observation, variable and data files */
+    char *groups; /**< name of the group file, NULL if the observations are not ranked within groups */
+    char *serve; /**< name of the Unix socket of the server, NULL if the program does not run as a server */
+    char *send; /**< name of the Unix socket of a server to which requests are sent, NULL if the program is not a client */
+    int entries; /**< maximal number of datasets kept in memory by the server */
+    char *variable_settings; /**< name of the settings file with the direction and weight of every variable, NULL if all variables are stimulants with equal weights */
+    char *batch; /**< name of the manifest file of the batch mode, NULL for the interactive mode */
+    char *updates; /**< name of the file with changes of the dataset applied incrementally, NULL for a single ranking */
+    int methods; /**< linear ordering methods, bit 1<<method is set for every method from aoimo_method */
+    resampling stability; /**< settings of the bootstrap or the jackknife, 0 replicates if the stability is not assessed */
+    char *sensitivity; /**< name of the file of the rank-shift matrix, NULL if the sensitivity is not analysed */
+    int jobs; /**< number of jobs of the batch mode computed at the same time */
+    int stream; /**< 1 if the ranking is computed from the files without keeping the dataset in memory, otherwise 0 */
+    char *generate; /**< prefix of the names of the files of a generated dataset, NULL if no dataset is generated */
+    int shape[2]; /**< number of observations and variables of a generated dataset */
+    int distribution; /**< distribution of values of a generated dataset: 0 - uniform, 1 - normal, 2 - lognormal, 3 - ties */
+    char *benchmark; /**< name of the file of the timings of phases, NULL if the phases are not timed */
+    int repeat; /**< number of times the phases are timed */
+    char *metrics; /**< name of the JSON file of metrics of phases, "-" for a summary in the standard error stream, NULL if phases are not measured */
+    int format; /**< format of the results file: 0 - text, 1 - CSV, 2 - binary */
+} options;
 
 /**
-An error handler that returns a coeff value when provided coefficient by user is a positive float number, otherwise an error.
+A structure that stores the header of a binary results file.
 */
-float errhl_coeff();
+typedef struct results_header{
+    char magic[8]; /**< the text AOIMORNK */
+    unsigned int byte_order; /**< 0x01020304 written in the byte order of the machine */
+    unsigned int version; /**< version of the format */
+    int rankings; /**< number of rankings */
+    int positions; /**< number of positions of every ranking */
+} results_header;
+
+/**
+A structure that stores a position of a ranking in a binary results file.
+*/
+typedef struct results_record{
+    double index; /**< index value of the observation */
+    int id; /**< observation ID (line of the observation file from 0) */
+    int method; /**< method of the ranking, from aoimo_method */
+} results_record;
+
+/**
+A structure that stores the metrics of a phase of a ranking.
+*/
+typedef struct phase_metrics{
+    double time; /**< wall time in seconds */
+    long long bytes_read; /**< number of bytes of read files */
+    long long bytes_written; /**< number of bytes of written files */
+    long long values; /**< number of parsed or loaded values */
+    long peak_memory; /**< peak resident memory of the process at the end of the phase in kilobytes */
+} phase_metrics;
+
+/**
+A structure that stores the timings of the refreshes of --updates compared with complete computations of the same datasets (--benchmark with --updates).
+*/
+typedef struct refresh_timing{
+    int refreshes; /**< number of timed refreshes */
+    double incremental_minimum; /**< minimal time of incremental_refresh() in seconds */
+    double incremental_sum; /**< total time of incremental_refresh() in seconds */
+    double complete_minimum; /**< minimal time of compute_ranking() of the same dataset in seconds */
+    double complete_sum; /**< total time of compute_ranking() of the same dataset in seconds */
+    long long positions; /**< number of compared positions */
+    long long equal_positions; /**< number of positions with the same observation in both rankings */
+} refresh_timing;
+
+/**
+A structure that stores a job of the batch mode.
+*/
+typedef struct job{
+    char observations_database[MEMORY]; /**< name of the observation file */
+    char variables_database[MEMORY]; /**< name of the variable file */
+    char data_database[MEMORY]; /**< name of the data file */
+    char results[MEMORY]; /**< name of the results file */
+    float min_coeff; /**< minimal coefficient of variation */
+    int line; /**< line number of the job in the manifest file */
+    int failed; /**< 1 if the job could not be computed, otherwise 0 */
+} job;
+
+/**
+A structure that stores the jobs of the batch mode and the buffers of every job worker.
+*/
+typedef struct batch{
+    job *jobs; /**< jobs read from the manifest file */
+    int count; /**< number of jobs */
+    int top; /**< number of positions of the ranking written to the results files, 0 for all */
+    int methods; /**< linear ordering methods, see options */
+    int format; /**< format of the results files, see options */
+    dataset **data; /**< dataset of every job worker */
+    computation *work; /**< buffers of every job worker */
+    thread_pool **pools; /**< pool of threads of every job worker */
+} batch;
+
+/**
+A structure that stores a dataset kept in memory by the server, with its statistics and rankings.
+*/
+typedef struct cache_entry{
+    unsigned long long hash[3]; /**< content hashes of the observation, variable and data files */
+    struct stat status[3]; /**< device, inode, size and modification time of the files when they were hashed */
+    dataset *data; /**< dataset scaled by compute_ranking(), NULL if the entry is empty */
+    computation work; /**< statistics of variables and the rankings of the dataset */
+    unsigned long long used; /**< number of the last request which used the entry, the entry with the lowest one is replaced first */
+} cache_entry;
+
+/**
+A function that takes 3 parameters and prompts the user for the names of the observation, variable and data files, otherwise an error.
+\param observations_database[MEMORY] - a name of the observation file to be filled
+\param variables_database[MEMORY] - a name of the variable file to be filled
+\param data_database[MEMORY] - a name of the data file to be filled
+*/
+void read_file_names(char observations_database[], char variables_database[], char data_database[]);
+
+/**
+A function that takes a parameter, prompts the user for the observation, variable and data files and returns a pointer to a new dataset read from them, otherwise an error.
+\param *metrics - a pointer to the metrics of the load phase to be filled, NULL if the phase is not measured
+*/
+dataset *read_dataset(phase_metrics *metrics);
+
+/**
+A function that takes 6 parameters and writes descriptive statistics of variables into a results file.
+\param *results_file - a pointer to a FILE structure
+\param *variable - a pointer to a table of names of variables
+\param stats[variables_number] - an array of statistics of variables
+\param variables_number - an integer number of variables
+\param min_coeff - a float minimal coefficient of variation
+\param approximate - 1 if the median, quartiles and deciles are approximated, otherwise 0
+*/
+void write_statistics(FILE *results_file, const string_table *variable, statistics stats[], int variables_number, float min_coeff, int approximate);
+
+/**
+A function that takes 2 parameters, writes a double value into a text in the same format as printf("%f") and returns the number of written characters.
+Values below 10^9 are rounded to 6 decimal places with a single fma() and written with integer arithmetic, values very close to the half of the last decimal place, larger values and values which are not numbers are written by snprintf().
+\param value - a double value
+\param text[FORMAT_LENGTH] - a text to be filled
+*/
+int format_value(double value, char text[]);
+
+/**
+A function that takes 4 parameters and writes a position of a ranking ("1. 0.750000 - name") into a results file without fprintf().
+\param *results_file - a pointer to a FILE structure
+\param position - an integer position from 1
+\param index - a double index value
+\param *name - a pointer to the name of the observation
+*/
+void write_position(FILE *results_file, int position, double index, const char *name);
+
+/**
+A function that takes 6 parameters and writes descriptive statistics of variables and the rankings of the given methods into a results file in a given format, the rankings of methods other than the one already in the buffers are computed.
+\param *results_file - a pointer to a FILE structure, its buffer is enlarged to OUTPUT_BUFFER bytes, so nothing can be written to it before
+\param *work - a pointer to the buffers of a completed computation
+\param *pool - a pointer to a pool of threads
+\param methods - an integer set of methods, see options
+\param min_coeff - a float minimal coefficient of variation
+\param format - an integer format of the results file, see options
+*/
+void write_results(FILE *results_file, computation *work, thread_pool *pool, int methods, float min_coeff, int format);
+
+/**
+A function that takes 3 parameters and writes the ranking of every group into a results file after the global rankings.
+\param *results_file - a pointer to a FILE structure
+\param *groups - a pointer to a grouping after compute_groups()
+\param *data - a pointer to the dataset with the names of observations
+*/
+void write_groups(FILE *results_file, grouping *groups, dataset *data);
 
 /**
-A function that takes 2 parameters and returns data value, otherwise an error.
-\param data_file - a pointer to a FILE structure
-\param i - position in file
+A function that takes 4 parameters and writes descriptive statistics of variables and the ranking of an incremental ranking into a file, otherwise an error.
+\param *file_name - a pointer to the name of the results file
+\param *engine - a pointer to an incremental ranking
+\param top - an integer number of positions of the ranking written to the file, 0 for all
+\param min_coeff - a float minimal coefficient of variation
 */
-float errhl_data(FILE*data_file, int i);
+void write_incremental(char *file_name, incremental *engine, int top, float min_coeff);
 
 /**
-A function that takes 2 parameters and returns the minimum value of a given variable.
-\param data[observation_number][variables_number] - a float dataset
-\param i - an integer variable ID
-\see observation_number
-\see variables_number
+A function that takes 3 parameters and returns the percentiles of positions of all observations in the bootstrap or jackknife replicates (STABILITY_PERCENTILES for every observation), otherwise an error.
+\param *data - a pointer to a dataset, which is not scaled yet
+\param *pool - a pointer to a pool of threads
+\param *stability - a pointer to the settings of the resampling
 */
-float f_minimum(float data[observation_number][variables_number], int i);
+double *compute_stability(dataset *data, thread_pool *pool, resampling *stability);
 
 /**
-A function that takes 2 parameters and returns the maximum value of a given variable.
-\param data[observation_number][variables_number] - a float dataset
-\param i - an integer variable ID
-\see observation_number
-\see variables_number
+A function that takes 4 parameters and writes the percentiles of positions of all observations in the bootstrap or jackknife replicates into a results file.
+\param *results_file - a pointer to a FILE structure
+\param *data - a pointer to a dataset
+\param *stability - a pointer to the settings of the resampling
+\param percentiles[observation_number*STABILITY_PERCENTILES] - a double array of percentiles returned by compute_stability()
 */
-float f_maximum(float data[observation_number][variables_number], int i);
+void write_stability(FILE *results_file, dataset *data, resampling *stability, double percentiles[]);
 
 /**
-A function that takes 2 parameters and returns the mean value of a given variable.
-\param data[observation_number][variables_number] - a float dataset
-\param i - an integer variable ID
-\see observation_number
-\see variables_number
+A function that takes 4 parameters and writes the rank-shift matrix of the leave-one-variable-out analysis into a file, otherwise an error.
+\param *file_name - a pointer to the name of the file
+\param *work - a pointer to the buffers of a completed computation
+\param *pool - a pointer to a pool of threads
+\param min_coeff - a float minimal coefficient of variation
 */
-float f_mean(float data[observation_number][variables_number], int i);
+void write_sensitivity(char *file_name, computation *work, thread_pool *pool, float min_coeff);
 
 /**
-A function that takes 2 parameters and returns the median value of a given variable.
-\param data_copy[observation_number][variables_number] - a float sorted dataset
-\param i - an integer variable ID
-\see observation_number
-\see variables_number
+A function that takes a parameter, prompts the user for the files and computes the ranking of the standardized sum method from them in two passes without keeping the dataset in memory, otherwise an error.
+\param *settings - a pointer to the options
 */
-float f_median(float data[observation_number][variables_number], int i);
+void run_stream(options *settings);
 
 /**
-A function that takes 3 parameters and returns the standard deviation value of a given variable.
-\param data[observation_number][variables_number] - a float dataset
-\param mean_result[variabes_number] - a float array of mean values of variables
-\param i - an integer variable ID
-\see observation_number
-\see variables_number
+A function that takes a parameter and writes the observation, variable and data files of a dataset of random values with the shape, distribution and seed given in the options, otherwise an error.
+\param *settings - a pointer to the options
 */
-float f_standard_deviation(float data[observation_number][variables_number], float mean_result[variables_number], int i);
+void generate_dataset(options *settings);
 
 /**
-A function that takes 3 parameters and returns the coefficient of variation value of a given variable.
-\param mean_result[variabes_number] - a float array of mean values of variables
-\param sd_result[variales_number] - a float array of standard deviation values of variables
-\param i - an integer variable ID
-\see variables_number
+A function that takes a parameter, prompts the user for the files, computes the ranking of the standardized sum method repeat times with every phase timed separately and writes the timings into the benchmark file in the JSON format, otherwise an error.
+\param *settings - a pointer to the options
 */
-float f_coeff_of_variation(float mean_result[variables_number], float sd_result[variables_number], int i);
+void run_benchmark(options *settings);
 
 /**
-A function that takes 5 parameters and returns the scaled dataset.
-\param data[observation_number][variables_number] - a float dataset
-\param mean_result[variabes_number] - a float array of mean values of variables
-\param sd_result[variales_number] - a float array of standard deviation values of variables
-\param i - an integer column ID in dataset
-\param j - an integer row ID in dataset
-\see observation_number
-\see variables_number
+A function that returns the current time in seconds from a monotonic clock.
 */
-float f_scale(float data[observation_number][variables_number], float mean_result[variables_number], float sd_result[variables_number], int i, int j);
+double current_time();
 
 /**
-A function that takes 2 parameters and returns the mean value of given observation.
-\param data[observation_number][variables_number] - a float dataset
-\param i - an integer observation ID
-\see observation_number
-\see variables_number
+A function that takes 2 parameters and stores the wall time of a phase which started at a given time and the peak resident memory of the process.
+\param *metrics - a pointer to the metrics of the phase
+\param start - a double time of the start of the phase returned by current_time()
 */
-float ranking_f_mean(float data[observation_number][variables_number], int i);
+void finish_phase(phase_metrics *metrics, double start);
 
 /**
-A function that takes a parameter and returns the minimum value of mean values in observations array.
-\param ranking_mean_result[observation_number] - a float array of mean values
-\see observation_number
+A function that takes 3 parameters and computes the ranking of the standardized sum method like compute_ranking(), but with statistics, scaling, scoring and sorting done as separate passes, so every phase is measured.
+\param *work - a pointer to the buffers of the computation
+\param *pool - a pointer to a pool of threads
+\param metrics[METRICS_PHASES] - an array of metrics of phases to be filled
 */
-float ranking_f_minimum(float ranking_mean_result[observation_number]);
+void compute_phases(computation *work, thread_pool *pool, phase_metrics metrics[]);
 
 /**
-A function that takes a parameter and returns the maximum value of mean values in observations array.
-\param ranking_mean_result[observation_number] - a float array of mean values
-\see observation_number
+A function that takes 3 parameters and writes the metrics of phases into a JSON file or a summary into the standard error stream, otherwise an error.
+\param *file_name - a pointer to the name of the JSON file, "-" for the summary
+\param *work - a pointer to the buffers of a completed computation
+\param metrics[METRICS_PHASES] - an array of metrics of phases
 */
-float ranking_f_maximum(float ranking_mean_result[observation_number]);
+void write_metrics(char *file_name, computation *work, phase_metrics metrics[]);
 
 /**
-A function that takes 4 parameters and returns the index value of an observation.
-\param ranking_mean_result[observation_number] - a float array of mean values
-\param ranking_minimum_result - a result of ranking_f_minimum()
-\param ranking_maximum_result - a result of ranking_f_maximum()
-\param i - an integer observation ID
-\see observation_number
+A function that takes 5 parameters and applies the changes from the updates file to an incremental ranking of a dataset and writes the results, otherwise an error.
+\param *data - a pointer to a dataset, which is not scaled
+\param *pool - a pointer to a pool of threads
+\param *settings - a pointer to the options
+\param min_coeff - a float minimal coefficient of variation
+\param *results - a pointer to the name of the results file
 */
-float ranking_f_index(float ranking_mean_result[observation_number], float ranking_minimum_result, float ranking_maximum_result, int i);
+void run_updates(dataset *data, thread_pool *pool, options *settings, float min_coeff, char *results);
 
 /**
-A function that gather data from user entered .txt file, creates a two-dimensional array and its copy sorted by variables and returns descriptive statistics and observations rank to the .txt file with a used-defined name.
+A function that takes 3 parameters and brings an incremental ranking up to date, if timing is not NULL the refresh is timed and compared with a complete computation of the ranking of the same values, otherwise an error.
+\param *engine - a pointer to an incremental ranking
+\param *pool - a pointer to a pool of threads
+\param *timing - a pointer to the timings to be updated or NULL
 */
-int main(){
-    extern int observation_number,variables_number,data_number;
-    int i, j, k;
-    float temp;
-    char observations_database[MEMORY], variables_database[MEMORY], data_database[MEMORY], results[MEMORY], temp2[MEMORY];
+void refresh_updates(incremental *engine, thread_pool *pool, refresh_timing *timing);
 
+/**
+A function that takes 4 parameters and writes the timings of refreshes compared with complete computations into the benchmark file in the JSON format, otherwise an error.
+\param *file_name - a pointer to the name of the benchmark file
+\param *engine - a pointer to an incremental ranking
+\param *pool - a pointer to a pool of threads
+\param *timing - a pointer to the timings
+*/
+void write_refresh_timing(char *file_name, incremental *engine, thread_pool *pool, refresh_timing *timing);
+
+/**
+A function that takes a parameter and prints the message of an error returned by the library.
+\param *error - a pointer to the details of the error
+*/
+void print_error(aoimo_error *error);
+
+/**
+A function that takes 2 parameters and returns 1 if a line of a manifest file (or a request of the server) is a correct job and fills the job, 0 if it is incorrect and -1 if it is empty or a comment.
+\param line[] - a line of the manifest file
+\param *task - a pointer to the job to be filled
+*/
+int parse_job(const char line[], job *task);
+
+/**
+A function that takes 2 parameters and returns the number of jobs read from a manifest file, otherwise an error.
+\param *file_name - a pointer to the name of the manifest file
+\param **jobs - a pointer to an array of jobs to be allocated and filled
+*/
+int read_manifest(char *file_name, job **jobs);
+
+/**
+A function that takes a parameter, computes all jobs of the manifest file given in the options and returns 1 if any of them failed, otherwise 0.
+\param *settings - a pointer to the options
+*/
+int run_batch(options *settings);
+
+/**
+A function that takes a parameter and runs the server (see \ref server): it listens on the Unix socket given in the options and answers requests until the request quit comes.
+\param *settings - a pointer to the options
+*/
+int run_server(options *settings);
+
+/**
+A function that takes 2 parameters and returns 1 if the device, inode, size and modification time of two files are equal (the file did not change since it was hashed), otherwise 0.
+\param *a - a pointer to the status of the first file
+\param *b - a pointer to the status of the second file
+*/
+int same_file(const struct stat *a, const struct stat *b);
+
+/**
+A function that takes 5 parameters and answers a request of the server, the reply (a single line) is written into the reply buffer.
+\param line[] - a request in the format of a job of the manifest file
+\param entries[] - an array of datasets kept in memory
+\param *settings - a pointer to the options
+\param *pool - a pointer to a pool of threads
+\param reply[MEMORY*4] - a buffer of the reply
+*/
+void serve_request(const char line[], cache_entry entries[], options *settings, thread_pool *pool, char reply[]);
+
+/**
+A function that takes a parameter, sends the requests read from the standard input to the server given in the options and prints the replies, it returns 1 if any request failed, otherwise 0.
+\param *settings - a pointer to the options
+*/
+int run_client(options *settings);
+
+/**
+A function that takes 2 parameters and prints the time of compute_ranking() for 1, 2, 4, ... threads up to the number of threads of the pool and the speedup over a single thread, the dataset is not modified.
+\param *work - a pointer to the buffers of the computation
+\param threads - an integer maximal number of threads
+*/
+void report_scaling(computation *work, int threads);
+
+/**
+A function that takes 3 parameters and reads options provided in the command line, otherwise an error.
+\param argc - an integer number of arguments
+\param *argv[] - an array of arguments
+\param *settings - a pointer to the options to be filled
+*/
+void read_options(int argc, char *argv[], options *settings);
+
+/**
+An error handler that takes a parameter and returns an error when file does not exist.
+\param *file - a pointer to a FILE structure
+*/
+void errhl_file_exist(FILE*file);
+
+/**
+An error handler that takes a parameter and returns an error when memory could not be allocated.
+\param *pointer - a pointer returned by an allocation
+*/
+void errhl_memory(void *pointer);
+
+/**
+An error handler that takes 2 parameters and returns an error when tried to open the same file twice.
+\param *file_name - a pointer to a first file name provided
+\param *file_name2 - a pointer to a second file name provided
+*/
+void errhl_incorrect_file(char *file_name, char *file_name2);
+
+/**
+An error handler that takes 2 parameters and returns an error when a function of the library did not succeed.
+\param code - an integer error code returned by the library
+\param *error - a pointer to the details of the error
+*/
+void errhl_library(int code, aoimo_error *error);
+
+/**
+An error handler that takes a parameter and returns an error when a job in the manifest file is incorrect.
+\param line - an integer line number in the manifest file
+*/
+void errhl_manifest(int line);
+
+/**
+An error handler that takes a parameter and returns an error when a change in the updates file is incorrect.
+\param line - an integer line number in the updates file
+*/
+void errhl_updates(int line);
+
+/**
+An error handler that takes a parameter and returns an error when a command line option is unknown or its value is incorrect.
+\param *option - a pointer to the option
+*/
+void errhl_option(char *option);
+
+/**
+An error handler that returns a coeff value when provided coefficient by user is a positive float number, otherwise an error.
+*/
+float errhl_coeff();
+
+/**
+A function that gather data from user entered .txt file into a heap-allocated dataset and returns descriptive statistics and observations rank to the .txt file with a used-defined name.
+\param argc - an integer number of arguments
+\param *argv[] - an array of arguments (see \ref options)
+*/
+int main(int argc, char *argv[]){
+    float min_coeff;
+    char results[MEMORY];
+    dataset *data;
+    options settings;
+    thread_pool *pool;
+    computation work = {0};
+    grouping groups = {0};
+    variable_setting *directions = NULL;
+    aoimo_error error = {0};
+    double *percentiles = NULL, start;
+    phase_metrics metrics[METRICS_PHASES] = {{0}};
+    struct stat status;
+
+    read_options(argc, argv, &settings);
+
+    if(settings.generate!=NULL){
+        generate_dataset(&settings);
+        return 0;
+    }
+    if(settings.benchmark!=NULL && settings.updates==NULL){
+        run_benchmark(&settings);
+        return 0;
+    }
+    if(settings.batch!=NULL){
+        return run_batch(&settings);
+    }
+    if(settings.serve!=NULL){
+        return run_server(&settings);
+    }
+    if(settings.send!=NULL){
+        return run_client(&settings);
+    }
+    if(settings.stream){
+        run_stream(&settings);
+        return 0;
+    }
+
+    pool = thread_pool_create(settings.threads);
+    errhl_memory(pool);
+    if(settings.cache!=NULL){
+        start = current_time();
+        errhl_library(dataset_load_cache(&data, settings.cache, &error), &error);
+        finish_phase(&metrics[0], start);
+        metrics[0].bytes_read = stat(settings.cache, &status)==0 ? status.st_size : 0;
+        metrics[0].values = (long long)data->observation_number*data->variables_number;
+    }
+    else if(settings.table!=NULL){
+        start = current_time();
+        data = dataset_create(0, 0);
+        errhl_memory(data);
+        errhl_library(load_table(data, settings.table, pool, &error), &error);
+        finish_phase(&metrics[0], start);
+        metrics[0].bytes_read = stat(settings.table, &status)==0 ? status.st_size : 0;
+        metrics[0].values = (long long)data->observation_number*data->variables_number;
+    }
+    else{
+        data = read_dataset(settings.metrics!=NULL ? &metrics[0] : NULL);
+    }
+
+    if(settings.convert!=NULL){
+        errhl_library(dataset_save_cache(data, settings.convert, &error), &error);
+        thread_pool_free(pool);
+        dataset_free(data);
+        printf("\nCompleted. Dataset stored in %s file\n", settings.convert);
+        return 0;
+    }
+
+    errhl_library(computation_reserve(&work, data, settings.threads, settings.top), &error);
+    if(settings.variable_settings!=NULL){
+        directions = malloc(data->variables_number*sizeof(variable_setting));
+        errhl_memory(directions);
+        errhl_library(variable_settings_load(directions, settings.variable_settings, data->variables_number, &error), &error);
+        work.settings = directions;
+    }
+    if(settings.groups!=NULL){
+        errhl_library(grouping_load(&groups, settings.groups, data->observation_number, settings.top, &error), &error);
+        errhl_library(compute_groups(&groups, data, directions, pool), &error);
+    }
+
+    printf("Provide minimal coeff value (e.g. 10%% = 10): ");
+    min_coeff =errhl_coeff();
+
+    printf("Provide file name (results file) (e.g. Results.txt): ");
+    scanf("%s", results);
+
+    if(settings.updates!=NULL){
+        run_updates(data, pool, &settings, min_coeff, results);
+        thread_pool_free(pool);
+        computation_free(&work);
+        dataset_free(data);
+        printf("\nCompleted. Results stored in %s file\n", results);
+        return 0;
+    }
+
+    FILE *results_file=fopen(results, "w");
+    errhl_file_exist(results_file);
+
+    if(settings.scaling){
+        report_scaling(&work, settings.threads);
+    }
+    if(settings.stability.jackknife){
+        settings.stability.replicates = data->observation_number;
+    }
+    if(settings.stability.replicates>0){
+        percentiles = compute_stability(data, pool, &settings.stability);
+    }
+    if(settings.metrics!=NULL){
+        compute_phases(&work, pool, metrics);
+    }
+    else{
+        compute_ranking(&work, pool);
+    }
+    start = current_time();
+    write_results(results_file, &work, pool, settings.methods, min_coeff, settings.format);
+    if(settings.groups!=NULL){
+        write_groups(results_file, &groups, data);
+    }
+    if(settings.stability.replicates>0){
+        write_stability(results_file, data, &settings.stability, percentiles);
+        free(percentiles);
+    }
+    metrics[5].bytes_written = ftell(results_file);
+    fclose(results_file);
+    finish_phase(&metrics[5], start);
+    if(settings.sensitivity!=NULL){
+        write_sensitivity(settings.sensitivity, &work, pool, min_coeff);
+    }
+    if(settings.metrics!=NULL){
+        write_metrics(settings.metrics, &work, metrics);
+    }
+
+    thread_pool_free(pool);
+    computation_free(&work);
+    grouping_free(&groups);
+    free(directions);
+    dataset_free(data);
+
+    printf("\nCompleted. Results stored in %s file\n", results);
+    return 0;
+}
+
+void read_file_names(char observations_database[], char variables_database[], char data_database[]){
     printf("Provide file name (observation file) (e.g. Obs.txt): ");
     scanf("%s", observations_database);
     FILE *observation_file=fopen(observations_database, "r");
     errhl_file_exist(observation_file);
-
-    observation_number = counter(observation_file);
-    fseek(observation_file, 0, SEEK_SET);
-    char observation[observation_number][MEMORY];
-    for(i=0; i < observation_number; i++){
-        fgets(observation[i], MEMORY, observation_file);
-        if(observation[i][strlen(observation[i])-1]=='\n'){
-            observation[i][strlen(observation[i])-1]='\0';
-        }
-    }
     fclose(observation_file);
 
     printf("Provide file name (variable file) (e.g. Var.txt): ");
     scanf("%s", variables_database);
     FILE *variables_file=fopen(variables_database, "r");
     errhl_file_exist(variables_file);
-    errhl_incorrect_file(variables_database, observations_database);
-
-    variables_number = counter(variables_file);
-    fseek(variables_file, 0, SEEK_SET);
-    char variable[variables_number][MEMORY];
-    for(i=0; i < variables_number; i++){
-        fgets(variable[i], MEMORY, variables_file);
-        if(variable[i][strlen(variable[i])-1]=='\n'){
-            variable[i][strlen(variable[i])-1]='\0';
-        }
-    }
     fclose(variables_file);
+    errhl_incorrect_file(variables_database, observations_database);
 
     printf("Provide file name (data file) (e.g. Data.txt): ");
     scanf("%s", data_database);
-    FILE *data_file=fopen(data_database, "r");
-    errhl_file_exist(data_file);
     errhl_incorrect_file(data_database, observations_database);
     errhl_incorrect_file(data_database, variables_database);
+}
 
-    data_number = counter(data_file);
-    errhl_incorrect_data();
+dataset *read_dataset(phase_metrics *metrics){
+    char observations_database[MEMORY], variables_database[MEMORY], data_database[MEMORY];
+    char *file_names[3] = {observations_database, variables_database, data_database};
+    dataset *data;
+    aoimo_error error = {0};
+    double start = 0;
+    struct stat status;
+    int i;
 
-    fseek(data_file,0,SEEK_SET);
+    read_file_names(observations_database, variables_database, data_database);
+    if(metrics!=NULL){
+        start = current_time();
+    }
+    data = dataset_create(0, 0);
+    errhl_memory(data);
+    errhl_library(load_dataset(data, observations_database, variables_database, data_database, &error), &error);
+    if(metrics!=NULL){
+        finish_phase(metrics, start);
+        for(i=0; i<3; i++){
+            metrics->bytes_read += stat(file_names[i], &status)==0 ? status.st_size : 0;
+        }
+        metrics->values = (long long)data->observation_number*data->variables_number;
+    }
+    return data;
+}
+
+void write_statistics(FILE *results_file, const string_table *variable, statistics stats[], int variables_number, float min_coeff, int approximate){
+    const char *note = approximate ? " (approximate)" : "";
+    int i, j;
 
-    float data_download[data_number];
-    for(i=0; i <data_number; i++){
-        data_download[i]=errhl_data(data_file, i);
+    for(i=0;i<variables_number;i++)
+    {
+        fprintf(results_file, "Variable: %s\n", string_table_get(variable, i));
+        if (stats[i].coeff_of_variation<min_coeff){
+            fprintf(results_file, "NOTE: Required to remove variable %s due to low level of coefficient of variation\n", string_table_get(variable, i));
+        }
+        fprintf(results_file, "Minimum: %f\nMaximum: %f\nMean: %f\nMedian%s: %f\nFirst quartile%s: %f\nThird quartile%s: %f\nInterquartile range%s: %f\nStandard deviation: %f\nVariance: %f\nCoefficient of variation (%%): %f\nDeciles%s:" ,stats[i].minimum,stats[i].maximum,stats[i].mean,note,stats[i].median,note,stats[i].quartile_1,note,stats[i].quartile_3,note,stats[i].interquartile_range,stats[i].standard_deviation,stats[i].variance,stats[i].coeff_of_variation,note);
+        for(j=0;j<DECILES;j++){
+            fprintf(results_file, " %f", stats[i].decile[j]);
+        }
+        fprintf(results_file, "\n\n");
     }
+}
 
-    fclose(data_file);
+int format_value(double value, char text[]){
+    static const unsigned long long power[6] = {100000, 10000, 1000, 100, 10, 1};
+    double magnitude = fabs(value), scaled, residual;
+    unsigned long long integer, fraction;
+    char digits[20];
+    int length = 0, n = 0, i;
+
+    if(!(magnitude<1e9)){
+        return snprintf(text, FORMAT_LENGTH, "%f", value);
+    }
+    scaled = nearbyint(magnitude*1e6);
+    residual = fma(magnitude, 1e6, -scaled);
+    if(fabs(fabs(residual)-0.5)<1e-6){
+        return snprintf(text, FORMAT_LENGTH, "%f", value);
+    }
+    scaled += residual>0.5 ? 1 : residual<-0.5 ? -1 : 0;
+    integer = (unsigned long long)scaled/1000000;
+    fraction = (unsigned long long)scaled%1000000;
+    if(signbit(value)){
+        text[length++] = '-';
+    }
+    do{
+        digits[n++] = (char)('0'+integer%10);
+        integer /= 10;
+    }while(integer>0);
+    while(n>0){
+        text[length++] = digits[--n];
+    }
+    text[length++] = '.';
+    for(i=0; i<6; i++){
+        text[length++] = (char)('0'+fraction/power[i]%10);
+    }
+    text[length] = '\0';
+    return length;
+}
 
-    float data[observation_number][variables_number];
-    for(i=0;i<variables_number;i++){
-        for(j=0;j<observation_number;j++){
-            data[j][i]=data_download[k];
-            k++;
+/**
+A function that takes 2 parameters, writes a non-negative integer into a text without the terminating zero byte and returns the number of written characters.
+*/
+static int format_integer(int value, char text[]){
+    char digits[12];
+    int length = 0, n = 0;
+
+    do{
+        digits[n++] = (char)('0'+value%10);
+        value /= 10;
+    }while(value>0);
+    while(n>0){
+        text[length++] = digits[--n];
+    }
+    return length;
+}
+
+void write_position(FILE *results_file, int position, double index, const char *name){
+    char line[FORMAT_LENGTH+MEMORY+16];
+    int length = format_integer(position, line);
+    size_t name_length = strlen(name);
+
+    line[length++] = '.';
+    line[length++] = ' ';
+    length += format_value(index, line+length);
+    memcpy(line+length, " - ", 3);
+    length += 3;
+    if(name_length>MEMORY){
+        fwrite(line, 1, length, results_file);
+        fwrite(name, 1, name_length, results_file);
+        putc('\n', results_file);
+        return;
+    }
+    memcpy(line+length, name, name_length);
+    length += name_length;
+    line[length++] = '\n';
+    fwrite(line, 1, length, results_file);
+}
+
+/**
+A function that takes 6 parameters and writes a position of a ranking as a line of a CSV file, the name is quoted if it contains a comma, a quote or a line break.
+*/
+static void write_csv_position(FILE *results_file, const char *method, int position, double index, int id, const char *name){
+    char line[FORMAT_LENGTH+2*MEMORY+48];
+    size_t length = strlen(method);
+
+    memcpy(line, method, length);
+    line[length++] = ',';
+    length += format_integer(position, line+length);
+    line[length++] = ',';
+    length += format_value(index, line+length);
+    line[length++] = ',';
+    length += format_integer(id, line+length);
+    line[length++] = ',';
+    if(strlen(name)>MEMORY){
+        fwrite(line, 1, length, results_file);
+        length = 0;
+        if(strpbrk(name, ",\"\r\n")==NULL){
+            fputs(name, results_file);
+        }
+        else{
+            putc('"', results_file);
+            for(; *name!='\0'; name++){
+                if(*name=='"'){
+                    putc('"', results_file);
+                }
+                putc(*name, results_file);
+            }
+            putc('"', results_file);
+        }
+    }
+    else if(strpbrk(name, ",\"\r\n")==NULL){
+        memcpy(line+length, name, strlen(name));
+        length += strlen(name);
+    }
+    else{
+        line[length++] = '"';
+        for(; *name!='\0'; name++){
+            if(*name=='"'){
+                line[length++] = '"';
+            }
+            line[length++] = *name;
         }
+        line[length++] = '"';
     }
+    line[length++] = '\n';
+    fwrite(line, 1, length, results_file);
+}
 
-    float data_copy[observation_number][variables_number];
-    for(i=0; i<variables_number;i++){
-        for(j=0;j<observation_number; j++){
-            data_copy[j][i]=data[j][i];
+void write_results(FILE *results_file, computation *work, thread_pool *pool, int methods, float min_coeff, int format){
+    static const char *titles[AOIMO_METHODS] = {"", " (Hellwig method)", " (TOPSIS method)", " (rank method)"};
+    static const char *method_names[AOIMO_METHODS] = {"sum", "hellwig", "topsis", "rank"};
+    static const char *direction_names[3] = {"stimulant", "destimulant", "nominant"};
+    results_header header;
+    results_record record;
+    int method, i;
+
+    setvbuf(results_file, NULL, _IOFBF, OUTPUT_BUFFER);
+    if(format==0){
+        write_statistics(results_file, &work->data->variable, work->stats, work->data->variables_number, min_coeff, 0);
+        if(work->settings!=NULL){
+            fprintf(results_file, "\nVARIABLES\n");
+            for(i=0; i<work->data->variables_number; i++){
+                fprintf(results_file, "%s: %s", string_table_get(&work->data->variable, i), direction_names[work->settings[i].direction]);
+                if(work->settings[i].direction==AOIMO_NOMINANT){
+                    fprintf(results_file, " (target %f)", work->settings[i].target);
+                }
+                fprintf(results_file, ", weight %f\n", work->settings[i].weight*work->weight_factor);
+            }
+        }
+    }
+    else if(format==1){
+        fputs("method,position,index,observation_id,observation\n", results_file);
+    }
+    else{
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "AOIMORNK", 8);
+        header.byte_order = 0x01020304;
+        header.version = RESULTS_VERSION;
+        for(method=0; method<AOIMO_METHODS; method++){
+            header.rankings += (methods>>method)&1;
+        }
+        header.positions = work->top>0 && work->top<work->data->observation_number ? work->top : work->data->observation_number;
+        fwrite(&header, sizeof(header), 1, results_file);
+    }
+    for(method=0; method<AOIMO_METHODS; method++){
+        if(methods & 1<<method){
+            if(work->method!=method){
+                compute_method(work, pool, method);
+            }
+            if(format==0){
+                fprintf(results_file, "\nRANKING%s\n", titles[method]);
+            }
+            for(i=0; i<work->positions; i++){
+                if(format==0){
+                    write_position(results_file, i+1, work->order[i].index, string_table_get(&work->data->observation, work->order[i].id));
+                }
+                else if(format==1){
+                    write_csv_position(results_file, method_names[method], i+1, work->order[i].index, work->order[i].id, string_table_get(&work->data->observation, work->order[i].id));
+                }
+                else{
+                    record.index = work->order[i].index;
+                    record.id = work->order[i].id;
+                    record.method = method;
+                    fwrite(&record, sizeof(record), 1, results_file);
+                }
+            }
         }
     }
+}
 
-    float min_result[variables_number], max_result[variables_number], mean_result[variables_number], median_result[variables_number], sd_result[variables_number],var_result[variables_number], coeff_of_var_result[variables_number], ranking_mean_result[observation_number], ranking_index_result[observation_number], min_coeff;
+void write_groups(FILE *results_file, grouping *groups, dataset *data){
+    ranking_entry *order;
+    int g, i;
+
+    for(g=0; g<groups->group_number; g++){
+        fprintf(results_file, "\nRANKING (group %s)\n", string_table_get(&groups->name, g));
+        order = groups->order+groups->first[g];
+        for(i=0; i<groups->positions[g]; i++){
+            write_position(results_file, i+1, order[i].index, string_table_get(&data->observation, order[i].id));
+        }
+    }
+}
+
+void write_incremental(char *file_name, incremental *engine, int top, float min_coeff){
+    int positions = top>0 && top<engine->positions ? top : engine->positions;
+    int i;
+    FILE *results_file = fopen(file_name, "w");
+
+    errhl_file_exist(results_file);
+    setvbuf(results_file, NULL, _IOFBF, OUTPUT_BUFFER);
+    write_statistics(results_file, &engine->variable, engine->stats, engine->variables_number, min_coeff, 0);
+    fprintf(results_file, "\nRANKING\n");
+    for(i=0; i<positions; i++){
+        write_position(results_file, i+1, incremental_index(engine, i), string_table_get(&engine->observation, engine->order[i].id));
+    }
+    fclose(results_file);
+}
+
+/**
+A function that takes 5 parameters and writes a position of a streamed ranking into the results file.
+*/
+static void write_stream_position(void *context, int position, double index, int id, const char *name){
+    (void)id;
+    write_position(context, position+1, index, name);
+}
+
+void run_stream(options *settings){
+    char observations_database[MEMORY], variables_database[MEMORY], data_database[MEMORY], results[MEMORY];
+    float min_coeff;
+    stream *ranking;
+    aoimo_error error = {0};
+
+    read_file_names(observations_database, variables_database, data_database);
+    errhl_library(stream_open(&ranking, observations_database, variables_database, data_database, &error), &error);
 
     printf("Provide minimal coeff value (e.g. 10%% = 10): ");
     min_coeff =errhl_coeff();
 
     printf("Provide file name (results file) (e.g. Results.txt): ");
     scanf("%s", results);
-
     FILE *results_file=fopen(results, "w");
+    errhl_file_exist(results_file);
+    setvbuf(results_file, NULL, _IOFBF, OUTPUT_BUFFER);
 
-    for(i=0;i<variables_number;i++)
-    {
-        fprintf(results_file, "Variable: %s\n", variable[i]);
-        min_result[i]=f_minimum(data,i);
-        max_result[i]=f_maximum(data,i);
-        mean_result[i]=f_mean(data,i);
-        median_result[i]=f_median(data_copy,i);
-        sd_result[i]=f_standard_deviation(data, mean_result, i);
-        var_result[i]=pow(f_standard_deviation(data, mean_result, i),2);
-        coeff_of_var_result[i]=f_coeff_of_variation(mean_result, sd_result, i);
+    write_statistics(results_file, &ranking->variable, ranking->stats, ranking->variables_number, min_coeff, 1);
+    fprintf(results_file, "\nRANKING\n");
+    errhl_library(stream_rank(ranking, settings->top, write_stream_position, results_file, &error), &error);
+    fclose(results_file);
+    stream_close(ranking);
+
+    printf("\nCompleted. Results stored in %s file\n", results);
+}
 
-        if (coeff_of_var_result[i]<min_coeff){
-            fprintf(results_file, "NOTE: Required to remove variable %s due to low level of coefficient of variation\n", variable[i]);
+double current_time(){
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec+now.tv_nsec*1e-9;
+}
+
+void finish_phase(phase_metrics *metrics, double start){
+    struct rusage usage;
+
+    metrics->time = current_time()-start;
+    metrics->peak_memory = getrusage(RUSAGE_SELF, &usage)==0 ? usage.ru_maxrss : 0;
+}
+
+void generate_dataset(options *settings){
+    static const char *suffixes[3] = {"Obs.txt", "Var.txt", "Data.txt"};
+    char file_name[3][MEMORY];
+    unsigned long long state = settings->stability.seed, random;
+    double value, radius;
+    int i, j;
+    FILE *file[3];
+
+    for(i=0; i<3; i++){
+        if(snprintf(file_name[i], MEMORY, "%s%s", settings->generate, suffixes[i])>=MEMORY){
+            errhl_option("--generate");
+        }
+        file[i] = fopen(file_name[i], "w");
+        errhl_file_exist(file[i]);
+    }
+    for(i=0; i<settings->shape[0]; i++){
+        fprintf(file[0], i+1<settings->shape[0] ? "o%d\n" : "o%d", i+1);
+    }
+    for(j=0; j<settings->shape[1]; j++){
+        fprintf(file[1], j+1<settings->shape[1] ? "v%d\n" : "v%d", j+1);
+    }
+    for(j=0; j<settings->shape[1]; j++){
+        for(i=0; i<settings->shape[0]; i++){
+            random = next_random(&state);
+            if(settings->distribution==0){
+                value = (random>>11)*0x1p-53*100;
+            }
+            else if(settings->distribution==3){
+                value = (double)((random>>32)*10>>32)+1;
+            }
+            else{
+                radius = sqrt(-2*log(((random>>11)+1)*0x1p-53));
+                value = radius*cos(2*acos(-1)*(next_random(&state)>>11)*0x1p-53);
+                value = settings->distribution==1 ? 50+10*value : exp(value);
+            }
+            fprintf(file[2], "%.6f\n", value);
         }
-        fprintf(results_file, "Minimum: %f\nMaximum: %f\nMean: %f\nMedian: %f\nStandard deviation: %f\nVariance: %f\nCoefficient of variation (%%): %f\n\n" ,min_result[i],max_result[i],mean_result[i],median_result[i],sd_result[i],var_result[i],coeff_of_var_result[i]);
-        for(j=0;j<observation_number;j++){
-            data[j][i]=f_scale(data, mean_result, sd_result, i ,j);
+    }
+    for(i=0; i<3; i++){
+        if(ferror(file[i]) | fclose(file[i])){
+            errhl_file_exist(NULL);
         }
     }
+    printf("\nCompleted. Dataset stored in %s, %s and %s files\n", file_name[0], file_name[1], file_name[2]);
+}
 
-    for(i=0;i<observation_number;i++){
-        ranking_mean_result[i]=ranking_f_mean(data, i);
-    }
+/**
+A function that takes 3 parameters and computes the statistics of the variable i without quantiles.
+*/
+static void statistics_task(void *context, int i, int thread){
+    computation *work = context;
+
+    (void)thread;
+    f_statistics(work->data, i, &work->stats[i]);
+}
+
+/**
+A function that takes 3 parameters and computes the quantiles of the variable i.
+*/
+static void quantiles_task(void *context, int i, int thread){
+    computation *work = context;
+
+    f_distribution(work->data, work->data_copy+(size_t)thread*work->data->observation_number, i, &work->stats[i]);
+}
+
+void compute_phases(computation *work, thread_pool *pool, phase_metrics metrics[]){
+    double start = current_time();
+
+    thread_pool_run(pool, statistics_task, work, work->data->variables_number);
+    thread_pool_run(pool, quantiles_task, work, work->data->variables_number);
+    finish_phase(&metrics[1], start);
+    start = current_time();
+    compute_scaling(work, pool);
+    finish_phase(&metrics[2], start);
+    start = current_time();
+    compute_scores(work, pool, AOIMO_SUM_METHOD);
+    finish_phase(&metrics[3], start);
+    start = current_time();
+    work->positions = ranking_order(work->ranking_index_result, work->data->observation_number, work->top, work->order);
+    finish_phase(&metrics[4], start);
+}
+
+void write_metrics(char *file_name, computation *work, phase_metrics metrics[]){
+    static const char *phases[METRICS_PHASES] = {"load", "statistics", "scaling", "scoring", "sort", "output"};
+    double total = 0;
+    int p;
+    FILE *file = strcmp(file_name, "-")==0 ? stderr : fopen(file_name, "w");
 
-    for(i=0; i<observation_number;i++){
-        ranking_index_result[i]=ranking_f_index(ranking_mean_result, ranking_f_minimum(ranking_mean_result), ranking_f_maximum(ranking_mean_result), i);
+    errhl_file_exist(file);
+    for(p=0; p<METRICS_PHASES; p++){
+        total += metrics[p].time;
+    }
+    if(file==stderr){
+        fprintf(file, "\nPhase       Time (s)  Bytes read  Bytes written      Values  Peak memory (KB)\n");
+        for(p=0; p<METRICS_PHASES; p++){
+            fprintf(file, "%-10s  %8.4f  %10lld  %13lld  %10lld  %16ld\n", phases[p], metrics[p].time, metrics[p].bytes_read, metrics[p].bytes_written, metrics[p].values, metrics[p].peak_memory);
+        }
+        fprintf(file, "%-10s  %8.4f\n", "total", total);
+        return;
     }
+    fprintf(file, "{\n  \"observations\": %d,\n  \"variables\": %d,\n  \"phases\": [\n", work->data->observation_number, work->data->variables_number);
+    for(p=0; p<METRICS_PHASES; p++){
+        fprintf(file, "    {\"name\": \"%s\", \"seconds\": %.6f, \"bytes_read\": %lld, \"bytes_written\": %lld, \"values_parsed\": %lld, \"peak_memory_kb\": %ld}%s\n", phases[p], metrics[p].time, metrics[p].bytes_read, metrics[p].bytes_written, metrics[p].values, metrics[p].peak_memory, p+1<METRICS_PHASES ? "," : "");
+    }
+    fprintf(file, "  ],\n  \"total_seconds\": %.6f\n}\n", total);
+    fclose(file);
+}
 
-    for(i=0; i<observation_number-1; i++){
-        for(j=i+1; j<observation_number; j++){
-            if(ranking_index_result[j]>ranking_index_result[i]){
-                temp = ranking_index_result[j];
-                ranking_index_result[j] = ranking_index_result[i];
-                ranking_index_result[i] = temp;
+void run_benchmark(options *settings){
+    static const char *phases[BENCHMARK_PHASES] = {"load", "statistics", "quantiles", "scaling", "ranking", "output"};
+    char observations_database[MEMORY], variables_database[MEMORY], data_database[MEMORY], results[MEMORY];
+    double minimum[BENCHMARK_PHASES+1], sum[BENCHMARK_PHASES+1], time[BENCHMARK_PHASES+1], start;
+    unsigned long long checksum = 0xCBF29CE484222325ULL;
+    unsigned char bytes[sizeof(double)+sizeof(int)];
+    float min_coeff;
+    int r, p, i, k;
+    dataset *data;
+    thread_pool *pool;
+    computation work = {0};
+    aoimo_error error = {0};
+    FILE *results_file, *benchmark_file;
+
+    read_file_names(observations_database, variables_database, data_database);
+    printf("Provide minimal coeff value (e.g. 10%% = 10): ");
+    min_coeff =errhl_coeff();
+    printf("Provide file name (results file) (e.g. Results.txt): ");
+    scanf("%s", results);
 
-                strcpy(temp2, observation[j]);
-                strcpy(observation[j], observation[i]);
-                strcpy(observation[i], temp2);
-            }
+    data = dataset_create(0, 0);
+    errhl_memory(data);
+    pool = thread_pool_create(settings->threads);
+    errhl_memory(pool);
+    for(r=0; r<settings->repeat; r++){
+        start = current_time();
+        errhl_library(load_dataset(data, observations_database, variables_database, data_database, &error), &error);
+        errhl_library(computation_reserve(&work, data, settings->threads, settings->top), &error);
+        time[0] = current_time()-start;
+
+        start = current_time();
+        thread_pool_run(pool, statistics_task, &work, data->variables_number);
+        time[1] = current_time()-start;
+        start = current_time();
+        thread_pool_run(pool, quantiles_task, &work, data->variables_number);
+        time[2] = current_time()-start;
+        start = current_time();
+        compute_scaling(&work, pool);
+        time[3] = current_time()-start;
+        start = current_time();
+        compute_method(&work, pool, AOIMO_SUM_METHOD);
+        time[4] = current_time()-start;
+
+        start = current_time();
+        results_file=fopen(results, "w");
+        errhl_file_exist(results_file);
+        write_results(results_file, &work, pool, 1<<AOIMO_SUM_METHOD, min_coeff, settings->format);
+        fclose(results_file);
+        time[5] = current_time()-start;
+
+        time[BENCHMARK_PHASES] = 0;
+        for(p=0; p<BENCHMARK_PHASES; p++){
+            time[BENCHMARK_PHASES] += time[p];
+        }
+        for(p=0; p<=BENCHMARK_PHASES; p++){
+            minimum[p] = r==0 || time[p]<minimum[p] ? time[p] : minimum[p];
+            sum[p] = r==0 ? time[p] : sum[p]+time[p];
         }
     }
 
-    fprintf(results_file, "\nRANKING\n");
-    for(i=0; i<observation_number;){
-        fprintf(results_file, "%d. %f - %s\n", ++i, ranking_index_result[i], observation[i]);
+    for(i=0; i<work.positions; i++){
+        memcpy(bytes, &work.order[i].index, sizeof(double));
+        memcpy(bytes+sizeof(double), &work.order[i].id, sizeof(int));
+        for(k=0; k<(int)sizeof(bytes); k++){
+            checksum = (checksum^bytes[k])*0x100000001B3ULL;
+        }
     }
-    fclose(results_file);
 
+    benchmark_file=fopen(settings->benchmark, "w");
+    errhl_file_exist(benchmark_file);
+    fprintf(benchmark_file, "{\n  \"observations\": %d,\n  \"variables\": %d,\n  \"threads\": %d,\n  \"repeat\": %d,\n  \"phases\": {\n", data->observation_number, data->variables_number, thread_pool_threads(pool), settings->repeat);
+    for(p=0; p<BENCHMARK_PHASES; p++){
+        fprintf(benchmark_file, "    \"%s\": {\"min\": %.6f, \"mean\": %.6f}%s\n", phases[p], minimum[p], sum[p]/settings->repeat, p+1<BENCHMARK_PHASES ? "," : "");
+    }
+    fprintf(benchmark_file, "  },\n  \"total\": {\"min\": %.6f, \"mean\": %.6f},\n  \"checksum\": \"%016llx\"\n}\n", minimum[BENCHMARK_PHASES], sum[BENCHMARK_PHASES]/settings->repeat, checksum);
+    fclose(benchmark_file);
 
+    thread_pool_free(pool);
+    computation_free(&work);
+    dataset_free(data);
+    printf("\nCompleted. Results stored in %s file, timings stored in %s file\n", results, settings->benchmark);
+}
 
-    printf("\nCompleted. Results stored in %s file\n", results);
-    return 0;
+double *compute_stability(dataset *data, thread_pool *pool, resampling *stability){
+    static const double probabilities[STABILITY_PERCENTILES] = {0.05, 0.25, 0.5, 0.75, 0.95};
+    int *positions = malloc((size_t)data->observation_number*stability->replicates*sizeof(int));
+    double *percentiles = malloc((size_t)data->observation_number*STABILITY_PERCENTILES*sizeof(double));
+    aoimo_error error = {0};
+
+    errhl_memory(positions);
+    errhl_memory(percentiles);
+    errhl_library(ranking_resample(data, pool, stability, positions), &error);
+    errhl_library(resampling_percentiles(positions, data->observation_number, stability->replicates, probabilities, STABILITY_PERCENTILES, percentiles), &error);
+    free(positions);
+    return percentiles;
 }
 
-float f_minimum(float data[observation_number][variables_number], int i){
-    float minimum =data[0][i];
-    int j;
+void write_stability(FILE *results_file, dataset *data, resampling *stability, double percentiles[]){
+    int i, j;
 
-    for(j=1; j<observation_number;j++){
-        if(data[j][i]<minimum){
-            minimum=data[j][i];
+    fprintf(results_file, "\nSTABILITY (%d %s replicates, percentiles of position: 5%% 25%% 50%% 75%% 95%%)\n", stability->replicates, stability->jackknife ? "jackknife" : "bootstrap");
+    for(i=0; i<data->observation_number; i++){
+        fprintf(results_file, "%s:", string_table_get(&data->observation, i));
+        for(j=0; j<STABILITY_PERCENTILES; j++){
+            fprintf(results_file, " %g", percentiles[(size_t)i*STABILITY_PERCENTILES+j]);
         }
+        fprintf(results_file, "\n");
     }
-    return minimum;
 }
 
-float f_maximum(float data[observation_number][variables_number], int i){
-    float maximum = data[0][i];
-    int j;
+void write_sensitivity(char *file_name, computation *work, thread_pool *pool, float min_coeff){
+    dataset *data = work->data;
+    int n = data->observation_number, m = data->variables_number, i, j;
+    int *positions = malloc(n*sizeof(int)), *shifts = malloc((size_t)n*m*sizeof(int)), *order = malloc(n*sizeof(int));
+    FILE *file;
+
+    errhl_memory(positions);
+    errhl_memory(shifts);
+    errhl_memory(order);
+    ranking_sensitivity(work, pool, positions, shifts);
+    for(i=0; i<n; i++){
+        order[positions[i]-1] = i;
+    }
 
-    for(j=1; j<observation_number;j++){
-        if(data[j][i]>maximum){
-            maximum=data[j][i];
+    file = fopen(file_name, "w");
+    errhl_file_exist(file);
+    fprintf(file, "Observation\tPosition");
+    for(j=0; j<m; j++){
+        fprintf(file, "\t%s%s", string_table_get(&data->variable, j), work->stats[j].coeff_of_variation<min_coeff ? "*" : "");
+    }
+    for(i=0; i<n; i++){
+        fprintf(file, "\n%s\t%d", string_table_get(&data->observation, order[i]), i+1);
+        for(j=0; j<m; j++){
+            fprintf(file, "\t%+d", shifts[(size_t)order[i]*m+j]);
         }
     }
-    return maximum;
+    fprintf(file, "\n");
+    fclose(file);
+    free(positions);
+    free(shifts);
+    free(order);
 }
 
-float f_mean(float data[observation_number][variables_number], int i){
-    float mean, sum=0;
-    int j;
+void run_updates(dataset *data, thread_pool *pool, options *settings, float min_coeff, char *results){
+    char line[4096], command[MEMORY], *p, *end;
+    double *values;
+    int line_number = 0, length, id, j, code = AOIMO_OK;
+    incremental *engine;
+    aoimo_error error = {0};
+    refresh_timing timing = {0};
+    FILE *file = fopen(settings->updates, "r");
+
+    errhl_file_exist(file);
+    errhl_library(incremental_create(&engine, data), &error);
+    values = malloc(data->variables_number*sizeof(double));
+    errhl_memory(values);
+    incremental_refresh(engine, pool);
+
+    while(fgets(line, sizeof(line), file)!=NULL){
+        line_number++;
+        length = strlen(line);
+        while(length>0 && (line[length-1]=='\n' || line[length-1]=='\r')){
+            line[--length] = '\0';
+        }
+        if(sscanf(line, "%101s%n", command, &length)!=1 || command[0]=='#'){
+            continue;
+        }
+        p = line+length;
+        if(strcmp(command, "insert")==0 || strcmp(command, "update")==0){
+            for(j=0; j<data->variables_number; j++){
+                values[j] = strtod(p, &end);
+                if(end==p){
+                    errhl_updates(line_number);
+                }
+                p = end;
+            }
+        }
+        else if(strcmp(command, "refresh")==0){
+            if(sscanf(p, "%101s", command)!=1){
+                errhl_updates(line_number);
+            }
+            refresh_updates(engine, pool, settings->benchmark!=NULL ? &timing : NULL);
+            write_incremental(command, engine, settings->top, min_coeff);
+            continue;
+        }
+        else if(strcmp(command, "delete")!=0){
+            errhl_updates(line_number);
+        }
+        while(*p==' ' || *p=='\t'){
+            p++;
+        }
+        if(*p=='\0'){
+            errhl_updates(line_number);
+        }
+        id = incremental_find(engine, p);
+        if(command[0]=='i'){
+            code = incremental_insert(engine, p, values);
+        }
+        else if(id<0){
+            errhl_updates(line_number);
+        }
+        else if(command[0]=='u'){
+            code = incremental_update(engine, id, values);
+        }
+        else{
+            code = incremental_delete(engine, id);
+        }
+        errhl_library(code, &error);
+    }
+    fclose(file);
 
-    for(j=0; j<observation_number;j++){
-        sum+=data[j][i];
+    refresh_updates(engine, pool, settings->benchmark!=NULL ? &timing : NULL);
+    write_incremental(results, engine, settings->top, min_coeff);
+    if(settings->benchmark!=NULL){
+        write_refresh_timing(settings->benchmark, engine, pool, &timing);
     }
-    mean=sum/observation_number;
-    return mean;
+    incremental_free(engine);
+    free(values);
 }
 
-float f_median(float data_copy[observation_number][variables_number], int i){
-    float median, temp;
-    int j, k;
-
-    median = 0;
-    for(j=0; j<observation_number-1; j++){
-        for(k=j+1; k<observation_number; k++){
-            if(data_copy[j][i]<data_copy[k][i]){
-                temp = data_copy[j][i];
-                data_copy[j][i] = data_copy[k][i];
-                data_copy[k][i] = temp;
-            }
+void refresh_updates(incremental *engine, thread_pool *pool, refresh_timing *timing){
+    int n = engine->observation_number, m = engine->variables_number, i, j;
+    double start = current_time(), time, *values;
+    computation work = {0};
+    aoimo_error error = {0};
+    dataset *data;
+
+    incremental_refresh(engine, pool);
+    time = current_time()-start;
+    if(timing==NULL || n==0){
+        return;
+    }
+    timing->incremental_minimum = timing->refreshes==0 || time<timing->incremental_minimum ? time : timing->incremental_minimum;
+    timing->incremental_sum += time;
+
+    values = malloc((size_t)n*m*sizeof(double));
+    errhl_memory(values);
+    for(i=0; i<n; i++){
+        for(j=0; j<m; j++){
+            values[(size_t)j*n+i] = engine->values[(size_t)i*m+j];
         }
     }
-    if(observation_number%2==0){
-        median = (data_copy[observation_number/2][i]+data_copy[observation_number/2-1][i])/2;
-        return median;
-    }
-    else{
-        median = data_copy[observation_number/2][i];
-        return median;
+    data = dataset_from_arrays(n, m, values, NULL, NULL);
+    errhl_memory(data);
+    free(values);
+    errhl_library(computation_reserve(&work, data, thread_pool_threads(pool), 0), &error);
+    start = current_time();
+    compute_ranking(&work, pool);
+    time = current_time()-start;
+    timing->complete_minimum = timing->refreshes==0 || time<timing->complete_minimum ? time : timing->complete_minimum;
+    timing->complete_sum += time;
+
+    for(i=0; i<n; i++){
+        timing->equal_positions += engine->id[work.order[i].id]==engine->order[i].id;
     }
+    timing->positions += n;
+    timing->refreshes++;
+    computation_free(&work);
+    dataset_free(data);
 }
 
-float f_standard_deviation(float data[observation_number][variables_number], float mean_result[variables_number], int i){
-    float sd=0;
-    int j;
+void write_refresh_timing(char *file_name, incremental *engine, thread_pool *pool, refresh_timing *timing){
+    int refreshes = timing->refreshes>0 ? timing->refreshes : 1;
+    FILE *file = fopen(file_name, "w");
 
-    for (j=0; j<observation_number; j++){
-        sd += pow(data[j][i]-mean_result[i],2);
-    }
-    sd=sqrt(sd/observation_number);
-    return sd;
+    errhl_file_exist(file);
+    fprintf(file, "{\n  \"observations\": %d,\n  \"variables\": %d,\n  \"threads\": %d,\n  \"refreshes\": %d,\n", engine->observation_number, engine->variables_number, thread_pool_threads(pool), timing->refreshes);
+    fprintf(file, "  \"incremental\": {\"min\": %.6f, \"mean\": %.6f},\n", timing->incremental_minimum, timing->incremental_sum/refreshes);
+    fprintf(file, "  \"complete\": {\"min\": %.6f, \"mean\": %.6f},\n", timing->complete_minimum, timing->complete_sum/refreshes);
+    fprintf(file, "  \"speedup\": %.3f,\n  \"positions\": %lld,\n  \"equal_positions\": %lld\n}\n", timing->incremental_sum>0 ? timing->complete_sum/timing->incremental_sum : 0, timing->positions, timing->equal_positions);
+    fclose(file);
 }
 
-float f_coeff_of_variation(float mean_result[variables_number], float sd_result[variables_number], int i){
-    float coeff_of_var = fabs(sd_result[i]/mean_result[i]*100);
-    return coeff_of_var;
+int parse_job(const char line[], job *task){
+    char coeff[MEMORY], rest[2], *end;
+    int fields = sscanf(line, "%101s %101s %101s %101s %101s %1s", task->observations_database, task->variables_database, task->data_database, coeff, task->results, rest);
+
+    if(fields<=0 || task->observations_database[0]=='#'){
+        return -1;
+    }
+    task->min_coeff = strtof(coeff, &end);
+    task->failed = 0;
+    return fields==5 && *end=='\0' && end!=coeff && task->min_coeff>=0;
 }
 
-float f_scale(float data[observation_number][variables_number], float mean_result[variables_number],  float sd_result[variables_number], int i, int j){
-    float scaled_value = (data[j][i]-mean_result[i])/sd_result[i];
-    return scaled_value;
+int read_manifest(char *file_name, job **jobs){
+    char line[4*MEMORY+MEMORY];
+    int count = 0, capacity = 16, line_number = 0, status;
+    job *task;
+    FILE *file = fopen(file_name, "r");
+
+    errhl_file_exist(file);
+    *jobs = malloc(capacity*sizeof(job));
+    errhl_memory(*jobs);
+    while(fgets(line, sizeof(line), file)!=NULL){
+        line_number++;
+        if(count==capacity){
+            capacity *= 2;
+            *jobs = realloc(*jobs, capacity*sizeof(job));
+            errhl_memory(*jobs);
+        }
+        task = &(*jobs)[count];
+        status = parse_job(line, task);
+        if(status<0){
+            continue;
+        }
+        task->line = line_number;
+        if(status==0){
+            errhl_manifest(line_number);
+        }
+        count++;
+    }
+    fclose(file);
+    return count;
 }
 
-float ranking_f_mean(float data[observation_number][variables_number], int i){
-    float mean, sum=0;
-    int j;
+/**
+A function that takes 3 parameters and computes the job i on the job worker thread.
+*/
+static void job_task(void *context, int i, int thread){
+    batch *jobs = context;
+    job *task = &jobs->jobs[i];
+    computation *work = &jobs->work[thread];
+    aoimo_error error = {0};
+    FILE *results_file;
+    int code;
+
+    if(strcmp(task->observations_database, task->variables_database)==0 || strcmp(task->data_database, task->observations_database)==0 || strcmp(task->data_database, task->variables_database)==0){
+        printf("\nJob in line %d of the manifest file:", task->line);
+        printf("\nDUPLICATE FILE ERROR: Tried to open the same file \n");
+        task->failed = 1;
+        return;
+    }
+    code = load_dataset(jobs->data[thread], task->observations_database, task->variables_database, task->data_database, &error);
+    if(code==AOIMO_OK){
+        code = computation_reserve(work, jobs->data[thread], thread_pool_threads(jobs->pools[thread]), jobs->top);
+        error.code = code;
+    }
+    if(code!=AOIMO_OK){
+        printf("\nJob in line %d of the manifest file:", task->line);
+        print_error(&error);
+        task->failed = 1;
+        return;
+    }
+    compute_ranking(work, jobs->pools[thread]);
 
-    for(j=0; j<variables_number;j++){
-        sum+=data[i][j];
+    results_file = fopen(task->results, "w");
+    if(results_file==NULL){
+        printf("\nJob in line %d of the manifest file:", task->line);
+        perror("\nEXISTENCE ERROR");
+        task->failed = 1;
+        return;
     }
-    mean=sum/variables_number;
-    return mean;
+    write_results(results_file, work, jobs->pools[thread], jobs->methods, task->min_coeff, jobs->format);
+    fclose(results_file);
+    printf("Completed. Results stored in %s file\n", task->results);
 }
 
-float ranking_f_minimum(float ranking_mean_result[observation_number]){
-    float minimum;
-    int i;
+int run_batch(options *settings){
+    batch jobs;
+    thread_pool *pool;
+    int workers, failed = 0, i;
+
+    jobs.count = read_manifest(settings->batch, &jobs.jobs);
+    jobs.top = settings->top;
+    jobs.methods = settings->methods;
+    jobs.format = settings->format;
+    workers = settings->jobs<jobs.count ? settings->jobs : jobs.count;
+    if(workers<1){
+        workers = 1;
+    }
 
-    for(i=0;i<observation_number;i++){
-        if(ranking_mean_result[i]<minimum){
-            minimum=ranking_mean_result[i];
-        }
+    jobs.data = malloc(workers*sizeof(dataset*));
+    jobs.work = calloc(workers, sizeof(computation));
+    jobs.pools = malloc(workers*sizeof(thread_pool*));
+    errhl_memory(jobs.data);
+    errhl_memory(jobs.work);
+    errhl_memory(jobs.pools);
+    for(i=0; i<workers; i++){
+        jobs.data[i] = dataset_create(0, 0);
+        jobs.pools[i] = thread_pool_create(settings->threads);
+        errhl_memory(jobs.data[i]);
+        errhl_memory(jobs.pools[i]);
     }
-    return minimum;
-}
 
-float ranking_f_maximum(float ranking_mean_result[observation_number]){
-    float maximum;
-    int i;
+    pool = thread_pool_create(workers);
+    errhl_memory(pool);
+    thread_pool_run(pool, job_task, &jobs, jobs.count);
+    thread_pool_free(pool);
+
+    for(i=0; i<workers; i++){
+        dataset_free(jobs.data[i]);
+        computation_free(&jobs.work[i]);
+        thread_pool_free(jobs.pools[i]);
+    }
+    for(i=0; i<jobs.count; i++){
+        failed += jobs.jobs[i].failed;
+    }
+    free(jobs.data);
+    free(jobs.work);
+    free(jobs.pools);
+    free(jobs.jobs);
+    printf("\nCompleted. %d jobs computed, %d jobs failed\n", jobs.count-failed, failed);
+    return failed>0;
+}
 
-    for(i=0; i<observation_number;i++){
-        if(ranking_mean_result[i]>maximum){
-            maximum=ranking_mean_result[i];
+void serve_request(const char line[], cache_entry entries[], options *settings, thread_pool *pool, char reply[]){
+    static const char *error_names[] = {"OK", "EXISTENCE ERROR", "EMPTY FILE ERROR", "DATA ERROR", "DATA FORMAT ERROR", "MEMORY ERROR", "CACHE FORMAT ERROR", "OBSERVATION ERROR", "FIELD ERROR", "GROUP ERROR", "SETTINGS ERROR"};
+    static unsigned long long requests = 0;
+    const char *file_names[3];
+    unsigned long long hash[3];
+    struct stat status[3];
+    cache_entry *entry = NULL;
+    aoimo_error error = {0};
+    FILE *results_file;
+    double start = current_time();
+    int code = AOIMO_OK, loaded = 0, i;
+    job task;
+
+    requests++;
+    if(parse_job(line, &task)!=1){
+        strcpy(reply, "ERROR Incorrect request");
+        return;
+    }
+    if(strcmp(task.observations_database, task.variables_database)==0 || strcmp(task.data_database, task.observations_database)==0 || strcmp(task.data_database, task.variables_database)==0){
+        strcpy(reply, "ERROR DUPLICATE FILE ERROR");
+        return;
+    }
+    file_names[0] = task.observations_database;
+    file_names[1] = task.variables_database;
+    file_names[2] = task.data_database;
+    for(i=0; i<3 && code==AOIMO_OK; i++){
+        if(stat(file_names[i], &status[i])!=0){
+            code = AOIMO_EXISTENCE_ERROR;
+            error.file_name = file_names[i];
+            error.system_error = errno;
+        }
+    }
+    for(i=0; i<settings->entries && code==AOIMO_OK && entry==NULL; i++){
+        if(entries[i].data!=NULL && same_file(&entries[i].status[0], &status[0]) && same_file(&entries[i].status[1], &status[1]) && same_file(&entries[i].status[2], &status[2])){
+            entry = &entries[i];
+        }
+    }
+    for(i=0; i<3 && code==AOIMO_OK && entry==NULL; i++){
+        code = file_hash(file_names[i], &hash[i], &error);
+    }
+    for(i=0; i<settings->entries && code==AOIMO_OK && entry==NULL; i++){
+        if(entries[i].data!=NULL && memcmp(entries[i].hash, hash, sizeof(hash))==0){
+            entry = &entries[i];
+            memcpy(entry->status, status, sizeof(status));
         }
     }
-    return maximum;
+    if(code==AOIMO_OK && entry==NULL){
+        entry = &entries[0];
+        for(i=1; i<settings->entries; i++){
+            if(entries[i].used<entry->used){
+                entry = &entries[i];
+            }
+        }
+        dataset_free(entry->data);
+        computation_free(&entry->work);
+        memset(entry, 0, sizeof(*entry));
+        entry->data = dataset_create(0, 0);
+        code = entry->data==NULL ? AOIMO_MEMORY_ERROR : load_dataset(entry->data, file_names[0], file_names[1], file_names[2], &error);
+        if(code==AOIMO_OK){
+            code = computation_reserve(&entry->work, entry->data, thread_pool_threads(pool), settings->top);
+        }
+        if(code==AOIMO_OK){
+            compute_ranking(&entry->work, pool);
+            memcpy(entry->hash, hash, sizeof(hash));
+            memcpy(entry->status, status, sizeof(status));
+            loaded = 1;
+        }
+        else{
+            dataset_free(entry->data);
+            entry->data = NULL;
+        }
+    }
+    if(code!=AOIMO_OK){
+        error.code = code;
+        printf("\nRequest: %s", line);
+        print_error(&error);
+        snprintf(reply, 4*MEMORY, "ERROR %s%s%s", error_names[code], error.file_name!=NULL ? " " : "", error.file_name!=NULL ? error.file_name : "");
+        return;
+    }
+    entry->used = requests;
+
+    results_file = fopen(task.results, "w");
+    if(results_file==NULL){
+        snprintf(reply, 4*MEMORY, "ERROR EXISTENCE ERROR %s", task.results);
+        return;
+    }
+    write_results(results_file, &entry->work, pool, settings->methods, task.min_coeff, settings->format);
+    fclose(results_file);
+    snprintf(reply, 4*MEMORY, "OK %s %.3f ms %s", loaded ? "loaded" : "cached", (current_time()-start)*1000, task.results);
 }
 
-float ranking_f_index(float ranking_mean_result[observation_number], float ranking_minimum_result, float ranking_maximum_result, int i){
-    float index;
+int same_file(const struct stat *a, const struct stat *b){
+    return a->st_dev==b->st_dev && a->st_ino==b->st_ino && a->st_size==b->st_size && a->st_mtim.tv_sec==b->st_mtim.tv_sec && a->st_mtim.tv_nsec==b->st_mtim.tv_nsec;
+}
+
+int run_server(options *settings){
+    struct timeval timeout = {SERVER_TIMEOUT, 0};
+    struct sockaddr_un address;
+    char line[4*MEMORY+MEMORY], reply[4*MEMORY];
+    cache_entry *entries = calloc(settings->entries, sizeof(cache_entry));
+    thread_pool *pool = thread_pool_create(settings->threads);
+    FILE *input, *output;
+    int server, client, stop = 0, i;
+
+    errhl_memory(entries);
+    errhl_memory(pool);
+    signal(SIGPIPE, SIG_IGN);
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, settings->serve);
+    unlink(settings->serve);
+    server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(server<0 || bind(server, (struct sockaddr*)&address, sizeof(address))!=0 || listen(server, 16)!=0){
+        perror("\nEXISTENCE ERROR");
+        exit(1);
+    }
+    printf("Listening on %s\n", settings->serve);
+    fflush(stdout);
 
-    index=(ranking_mean_result[i]-ranking_minimum_result)/(ranking_maximum_result - ranking_minimum_result);
+    while(!stop){
+        client = accept(server, NULL, NULL);
+        if(client<0){
+            continue;
+        }
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        input = fdopen(client, "r");
+        output = fdopen(dup(client), "w");
+        if(input==NULL || output==NULL){
+            perror("\nEXISTENCE ERROR");
+            exit(1);
+        }
+        while(!stop && fgets(line, sizeof(line), input)!=NULL){
+            if(strncmp(line, "quit", 4)==0 && strspn(line+4, " \t\r\n")==strlen(line+4)){
+                strcpy(reply, "OK quit");
+                stop = 1;
+            }
+            else{
+                serve_request(line, entries, settings, pool, reply);
+            }
+            fprintf(output, "%s\n", reply);
+            fflush(output);
+        }
+        fclose(input);
+        fclose(output);
+    }
 
-    return index;
+    close(server);
+    unlink(settings->serve);
+    for(i=0; i<settings->entries; i++){
+        dataset_free(entries[i].data);
+        computation_free(&entries[i].work);
+    }
+    free(entries);
+    thread_pool_free(pool);
+    printf("\nCompleted. Server on %s stopped\n", settings->serve);
+    return 0;
 }
 
-int counter(FILE *file){
-    char character;
-    int no=1;
+int run_client(options *settings){
+    struct sockaddr_un address;
+    char line[4*MEMORY+MEMORY];
+    FILE *input, *output;
+    int server, failed = 0;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, settings->send);
+    server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(server<0 || connect(server, (struct sockaddr*)&address, sizeof(address))!=0){
+        perror("\nEXISTENCE ERROR");
+        exit(1);
+    }
+    input = fdopen(server, "r");
+    output = fdopen(dup(server), "w");
+    if(input==NULL || output==NULL){
+        perror("\nEXISTENCE ERROR");
+        exit(1);
+    }
+    while(fgets(line, sizeof(line), stdin)!=NULL){
+        fputs(line, output);
+        if(line[strlen(line)-1]!='\n'){
+            putc('\n', output);
+        }
+        fflush(output);
+        if(fgets(line, sizeof(line), input)==NULL){
+            break;
+        }
+        fputs(line, stdout);
+        failed |= strncmp(line, "OK", 2)!=0;
+    }
+    fclose(input);
+    fclose(output);
+    return failed;
+}
 
-    character=getc(file);
-    if(character==EOF){
-        errhl_no_data();
+void report_scaling(computation *work, int threads){
+    dataset *data = work->data;
+    size_t size = (size_t)data->observation_number*data->variables_number;
+    double *original = malloc(size*sizeof(double));
+    double *reference = malloc(data->observation_number*sizeof(double));
+    double start, time, single_time = 0;
+    thread_pool *pool;
+    int count;
+
+    errhl_memory(original);
+    errhl_memory(reference);
+    memcpy(original, data->values, size*sizeof(double));
+
+    printf("\nThreads  Time (s)  Speedup  Identical ranking\n");
+    for(count=1; count<=threads; count = count*2>threads && count<threads ? threads : count*2){
+        pool = thread_pool_create(count);
+        errhl_memory(pool);
+        start = current_time();
+        compute_ranking(work, pool);
+        time = current_time()-start;
+        thread_pool_free(pool);
+        if(count==1){
+            single_time = time;
+            memcpy(reference, work->ranking_index_result, data->observation_number*sizeof(double));
+        }
+        printf("%7d  %8.4f  %7.2f  %s\n", count, time, single_time/time, memcmp(reference, work->ranking_index_result, data->observation_number*sizeof(double))==0 ? "yes" : "no");
+        memcpy(data->values, original, size*sizeof(double));
     }
-    while(character!=EOF){
-        character=getc(file);
-        if(character=='\n'){
-            no++;
+
+    free(original);
+    free(reference);
+}
+
+void read_options(int argc, char *argv[], options *settings){
+    static const char *method_names[AOIMO_METHODS] = {"sum", "hellwig", "topsis", "rank"};
+    static const char *distribution_names[DISTRIBUTIONS] = {"uniform", "normal", "lognormal", "ties"};
+    static const char *format_names[3] = {"text", "csv", "binary"};
+    char *end, *name;
+    int method, i;
+
+    settings->top = 0;
+    settings->threads = 1;
+    settings->scaling = 0;
+    settings->cache = NULL;
+    settings->convert = NULL;
+    settings->table = NULL;
+    settings->groups = NULL;
+    settings->variable_settings = NULL;
+    settings->serve = NULL;
+    settings->send = NULL;
+    settings->entries = 4;
+    settings->batch = NULL;
+    settings->updates = NULL;
+    settings->methods = 1<<AOIMO_SUM_METHOD;
+    settings->stability.replicates = 0;
+    settings->stability.jackknife = 0;
+    settings->stability.variables = 0;
+    settings->stability.seed = 0;
+    settings->sensitivity = NULL;
+    settings->jobs = 1;
+    settings->stream = 0;
+    settings->generate = NULL;
+    settings->shape[0] = 1000;
+    settings->shape[1] = 5;
+    settings->distribution = 0;
+    settings->benchmark = NULL;
+    settings->repeat = 1;
+    settings->metrics = NULL;
+    settings->format = 0;
+    for(i=1; i<argc; i++){
+        if(strcmp(argv[i], "--top")==0 && i+1<argc){
+            settings->top = (int)strtol(argv[++i], &end, 10);
+            if(*end!='\0' || settings->top<=0){
+                errhl_option(argv[i-1]);
+            }
+        }
+        else if(strcmp(argv[i], "--threads")==0 && i+1<argc){
+            settings->threads = (int)strtol(argv[++i], &end, 10);
+            if(*end!='\0' || settings->threads<0){
+                errhl_option(argv[i-1]);
+            }
+            if(settings->threads==0){
+                settings->threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+                if(settings->threads<1){
+                    settings->threads = 1;
+                }
+            }
+        }
+        else if(strcmp(argv[i], "--cache")==0 && i+1<argc){
+            settings->cache = argv[++i];
+        }
+        else if(strcmp(argv[i], "--convert")==0 && i+1<argc){
+            settings->convert = argv[++i];
+        }
+        else if(strcmp(argv[i], "--table")==0 && i+1<argc){
+            settings->table = argv[++i];
+        }
+        else if(strcmp(argv[i], "--groups")==0 && i+1<argc){
+            settings->groups = argv[++i];
+        }
+        else if(strcmp(argv[i], "--settings")==0 && i+1<argc){
+            settings->variable_settings = argv[++i];
+        }
+        else if(strcmp(argv[i], "--serve")==0 && i+1<argc){
+            settings->serve = argv[++i];
+            if(strlen(settings->serve)>=sizeof(((struct sockaddr_un*)0)->sun_path)){
+                errhl_option(argv[i-1]);
+            }
+        }
+        else if(strcmp(argv[i], "--send")==0 && i+1<argc){
+            settings->send = argv[++i];
+            if(strlen(settings->send)>=sizeof(((struct sockaddr_un*)0)->sun_path)){
+                errhl_option(argv[i-1]);
+            }
+        }
+        else if(strcmp(argv[i], "--entries")==0 && i+1<argc){
+            settings->entries = (int)strtol(argv[++i], &end, 10);
+            if(*end!='\0' || settings->entries<=0){
+                errhl_option(argv[i-1]);
+            }
+        }
+        else if(strcmp(argv[i], "--batch")==0 && i+1<argc){
+            settings->batch = argv[++i];
+        }
+        else if(strcmp(argv[i], "--method")==0 && i+1<argc){
+            settings->methods = 0;
+            for(name=strtok(argv[++i], ","); name!=NULL; name=strtok(NULL, ",")){
+                for(method=0; method<AOIMO_METHODS && strcmp(name, method_names[method])!=0; method++);
+                if(method==AOIMO_METHODS){
+                    errhl_option(argv[i-1]);
+                }
+                settings->methods |= 1<<method;
+            }
+            if(settings->methods==0){
+                errhl_option(argv[i-1]);
+            }
+        }
+        else if(strcmp(argv[i], "--bootstrap")==0 && i+1<argc){
+            settings->stability.replicates = (int)strtol(argv[++i], &end, 10);
+            if(*end!='\0' || settings->stability.replicates<=0){
+                errhl_option(argv[i-1]);
+            }
+        }
+        else if(strcmp(argv[i], "--jackknife")==0){
+            settings->stability.jackknife = 1;
+        }
+        else if(strcmp(argv[i], "--resample-variables")==0){
+            settings->stability.variables = 1;
+        }
+        else if(strcmp(argv[i], "--seed")==0 && i+1<argc){
+            settings->stability.seed = strtoull(argv[++i], &end, 10);
+            if(*end!='\0'){
+                errhl_option(argv[i-1]);
+            }
+        }
+        else if(strcmp(argv[i], "--sensitivity")==0 && i+1<argc){
+            settings->sensitivity = argv[++i];
+        }
+        else if(strcmp(argv[i], "--updates")==0 && i+1<argc){
+            settings->updates = argv[++i];
+        }
+        else if(strcmp(argv[i], "--jobs")==0 && i+1<argc){
+            settings->jobs = (int)strtol(argv[++i], &end, 10);
+            if(*end!='\0' || settings->jobs<=0){
+                errhl_option(argv[i-1]);
+            }
+        }
+        else if(strcmp(argv[i], "--scaling")==0){
+            settings->scaling = 1;
+        }
+        else if(strcmp(argv[i], "--stream")==0){
+            settings->stream = 1;
+        }
+        else if(strcmp(argv[i], "--generate")==0 && i+1<argc){
+            settings->generate = argv[++i];
+        }
+        else if(strcmp(argv[i], "--shape")==0 && i+1<argc){
+            settings->shape[0] = (int)strtol(argv[++i], &end, 10);
+            if(*end!='x' || settings->shape[0]<=0){
+                errhl_option(argv[i-1]);
+            }
+            settings->shape[1] = (int)strtol(end+1, &end, 10);
+            if(*end!='\0' || settings->shape[1]<=0){
+                errhl_option(argv[i-1]);
+            }
+        }
+        else if(strcmp(argv[i], "--distribution")==0 && i+1<argc){
+            for(settings->distribution=0; settings->distribution<DISTRIBUTIONS && strcmp(argv[i+1], distribution_names[settings->distribution])!=0; settings->distribution++);
+            if(settings->distribution==DISTRIBUTIONS){
+                errhl_option(argv[i]);
+            }
+            i++;
+        }
+        else if(strcmp(argv[i], "--benchmark")==0 && i+1<argc){
+            settings->benchmark = argv[++i];
+        }
+        else if(strcmp(argv[i], "--format")==0 && i+1<argc){
+            for(settings->format=0; settings->format<3 && strcmp(argv[i+1], format_names[settings->format])!=0; settings->format++);
+            if(settings->format==3){
+                errhl_option(argv[i]);
+            }
+            i++;
+        }
+        else if(strcmp(argv[i], "--metrics")==0 && i+1<argc){
+            settings->metrics = argv[++i];
         }
+        else if(strcmp(argv[i], "--repeat")==0 && i+1<argc){
+            settings->repeat = (int)strtol(argv[++i], &end, 10);
+            if(*end!='\0' || settings->repeat<=0){
+                errhl_option(argv[i-1]);
+            }
+        }
+        else{
+            errhl_option(argv[i]);
+        }
+    }
+    if(settings->stream && (settings->cache!=NULL || settings->convert!=NULL || settings->batch!=NULL || settings->updates!=NULL || settings->sensitivity!=NULL || settings->scaling || settings->methods!=1<<AOIMO_SUM_METHOD || settings->stability.replicates>0 || settings->stability.jackknife)){
+        errhl_option("--stream");
+    }
+    if(settings->format!=0 && (settings->updates!=NULL || settings->stream || settings->stability.replicates>0 || settings->stability.jackknife)){
+        errhl_option("--format");
+    }
+    if(settings->metrics!=NULL && (settings->batch!=NULL || settings->updates!=NULL || settings->stream || settings->convert!=NULL || settings->benchmark!=NULL)){
+        errhl_option("--metrics");
+    }
+    if(settings->table!=NULL && (settings->cache!=NULL || settings->batch!=NULL || settings->stream || settings->generate!=NULL)){
+        errhl_option("--table");
+    }
+    if(settings->groups!=NULL && (settings->batch!=NULL || settings->updates!=NULL || settings->stream || settings->convert!=NULL || settings->format!=0)){
+        errhl_option("--groups");
+    }
+    if(settings->variable_settings!=NULL && (settings->batch!=NULL || settings->updates!=NULL || settings->stream || settings->convert!=NULL || settings->stability.replicates>0 || settings->stability.jackknife)){
+        errhl_option("--settings");
+    }
+    if(settings->serve!=NULL && (settings->send!=NULL || settings->batch!=NULL || settings->cache!=NULL || settings->convert!=NULL || settings->table!=NULL || settings->groups!=NULL || settings->variable_settings!=NULL || settings->updates!=NULL || settings->stream || settings->generate!=NULL || settings->benchmark!=NULL || settings->metrics!=NULL || settings->sensitivity!=NULL || settings->scaling || settings->stability.replicates>0 || settings->stability.jackknife)){
+        errhl_option("--serve");
+    }
+    if(settings->send!=NULL && (settings->batch!=NULL || settings->cache!=NULL || settings->convert!=NULL || settings->table!=NULL || settings->stream || settings->generate!=NULL || settings->benchmark!=NULL)){
+        errhl_option("--send");
+    }
+    if(settings->benchmark!=NULL && (settings->groups!=NULL || settings->variable_settings!=NULL || settings->cache!=NULL || settings->table!=NULL || settings->convert!=NULL || settings->batch!=NULL || settings->sensitivity!=NULL || settings->scaling || settings->stream || settings->methods!=1<<AOIMO_SUM_METHOD || settings->stability.replicates>0 || settings->stability.jackknife)){
+        errhl_option("--benchmark");
     }
-    return no;
 }
 
 void errhl_file_exist(FILE*file){
@@ -521,6 +2139,13 @@ void errhl_file_exist(FILE*file){
     }
 }
 
+void errhl_memory(void *pointer){
+    if (pointer==NULL){
+        printf("\nMEMORY ERROR: Not enough memory to store the dataset\n");
+        exit(1);
+    }
+}
+
 void errhl_incorrect_file(char *file_name, char *file_name2){
     if (strcmp(file_name,file_name2)==0){
         printf("\nDUPLICATE FILE ERROR: Tried to open the same file \n");
@@ -528,15 +2153,61 @@ void errhl_incorrect_file(char *file_name, char *file_name2){
     }
 }
 
-void errhl_incorrect_data(){
-    if(observation_number*variables_number!=data_number){
-        printf("\nDATA ERROR: Incorrect data - Number of observations*variables does not match number of data\nNumber of observations: %d\nNumber of variables: %d\nNumber of data: %d\n", observation_number, variables_number, data_number);
+void print_error(aoimo_error *error){
+    switch(error->code){
+        case AOIMO_EXISTENCE_ERROR:
+            printf("\nEXISTENCE ERROR: %s: %s\n", error->file_name, strerror(error->system_error));
+            break;
+        case AOIMO_EMPTY_FILE_ERROR:
+            printf("\nEMPTY FILE ERROR: This file is empty\n");
+            break;
+        case AOIMO_DATA_ERROR:
+            printf("\nDATA ERROR: Incorrect data - Number of observations*variables does not match number of data\nNumber of observations: %d\nNumber of variables: %d\nNumber of data: %ld\n", error->observation_number, error->variables_number, error->data_number);
+            break;
+        case AOIMO_DATA_FORMAT_ERROR:
+            printf("\nDATA FORMAT ERROR: Value in position %ld is not a number or there is an empty row\n", error->position);
+            break;
+        case AOIMO_MEMORY_ERROR:
+            printf("\nMEMORY ERROR: Not enough memory to store the dataset\n");
+            break;
+        case AOIMO_CACHE_FORMAT_ERROR:
+            printf("\nCACHE FORMAT ERROR: File is not a dataset cache, it is damaged or it was written on an incompatible machine\n");
+            break;
+        case AOIMO_OBSERVATION_ERROR:
+            printf("\nOBSERVATION ERROR: The observation does not exist\n");
+            break;
+        case AOIMO_GROUP_ERROR:
+            printf("\nGROUP ERROR: %s: Number of group keys does not match number of observations\nNumber of observations: %d\nNumber of group keys: %ld\n", error->file_name, error->observation_number, error->data_number);
+            break;
+        case AOIMO_SETTINGS_ERROR:
+            printf("\nSETTINGS ERROR: %s: Incorrect or missing setting of the variable in line %ld\n", error->file_name, error->position);
+            break;
+        case AOIMO_FIELD_ERROR:
+            printf("\nFIELD ERROR: Row in line %ld has %ld values, the header has %d variables\n", error->position, error->data_number, error->variables_number);
+            break;
+    }
+}
+
+void errhl_library(int code, aoimo_error *error){
+    if(code!=AOIMO_OK){
+        error->code = code;
+        print_error(error);
         exit(1);
     }
 }
 
-void errhl_no_data(){
-    printf("\nEMPTY FILE ERROR: This file is empty\n");
+void errhl_option(char *option){
+    printf("\nOPTION ERROR: Unknown option or incorrect value of option %s\n", option);
+    exit(1);
+}
+
+void errhl_updates(int line){
+    printf("\nUPDATES ERROR: Incorrect change in line %d of the updates file\n", line);
+    exit(1);
+}
+
+void errhl_manifest(int line){
+    printf("\nMANIFEST ERROR: Incorrect job in line %d of the manifest file\n", line);
     exit(1);
 }
 
@@ -553,11 +2224,3 @@ float errhl_coeff(){
     return min_coeff;
 }
 
-float errhl_data(FILE*data_file, int i){
-    float value;
-    if(fscanf(data_file, "%f", &value)!=1){
-        printf("\nDATA FORMAT ERROR: Value in position %d is not a number or there is an empty row\n",i+1);
-        exit(1);
-    }
-    return value;
-}
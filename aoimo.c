@@ -0,0 +1,3464 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "aoimo.h"
+
+/**
+A macro, which is the number of values of a variable processed at once by f_statistics(), small enough to keep the block in the cache.
+*/
+#define STATISTICS_BLOCK 512
+
+/**
+A macro, which is the alignment in bytes of the header and the values in a binary cache file.
+*/
+#define CACHE_ALIGNMENT 64
+
+/**
+A macro, which is the version of the binary cache file format.
+*/
+#define CACHE_VERSION 1
+
+/**
+A macro, which is the number of observations in a block processed as a single task by compute_ranking().
+*/
+#define ROW_BLOCK 4096
+
+/**
+A macro, which is the length of a range below which f_quantiles() stops partitioning and uses insertion sort.
+*/
+#define SELECTION_CUTOFF 16
+
+/**
+A macro, which is the average number of moves per position allowed to insertion sort repairing the order of an incremental ranking, the order is sorted again when it is exceeded.
+*/
+#define REPAIR_MOVES 8
+
+/**
+A macro, which is the number of changes between two refreshes of an incremental ranking up to which the sorted values of variables are kept up to date by moving values, after more changes they are sorted again.
+*/
+#define SORTED_CHANGES 256
+
+/**
+A macro, which is the number of bytes of the data file read at once by stream_open().
+*/
+#define STREAM_CHUNK (1<<20)
+
+/**
+A macro, which is the number of bytes of the data file read at once by stream_rank() for a block of a variable.
+*/
+#define STREAM_SEGMENT (1<<16)
+
+/**
+A macro, which is the number of observations scored and sorted together by stream_rank(), every block is a single run of the external merge sort.
+*/
+#define STREAM_BLOCK 32768
+
+/**
+A macro, which is the maximal number of runs merged at once by stream_rank().
+*/
+#define STREAM_FAN_IN 64
+
+/**
+A macro, which is the number of positions of a run read at once while runs are merged.
+*/
+#define STREAM_MERGE_BUFFER 256
+
+/**
+A macro, which is the capacity of the quantile sketches of variables of a streamed ranking.
+*/
+#define STREAM_SKETCH_CAPACITY 1024
+
+/**
+A macro, which is the minimal number of bytes of a chunk of a table file parsed by a single task of load_table().
+*/
+#define TABLE_CHUNK (1<<16)
+
+/**
+A structure that stores the header of a binary cache file.
+*/
+typedef struct cache_header{
+    char magic[8]; /**< the text AOIMOBIN */
+    unsigned int byte_order; /**< 0x01020304 written in the byte order of the machine */
+    unsigned int version; /**< version of the format */
+    long long observation_number; /**< number of observations */
+    long long variables_number; /**< number of variables */
+    long long names_offset; /**< offset of the name table */
+    long long names_size; /**< size of the name table in bytes */
+    long long values_offset; /**< offset of the values, aligned to CACHE_ALIGNMENT */
+    char reserved[8]; /**< zero bytes completing the header to CACHE_ALIGNMENT bytes */
+} cache_header;
+
+/**
+A structure that stores a position of a run of a streamed ranking in a temporary file.
+*/
+typedef struct stream_record{
+    ranking_entry entry; /**< mean value and ID of the observation */
+    long long name; /**< offset of the name of the observation in the observation file */
+} stream_record;
+
+/**
+A structure that stores a file read in chunks by a streamed ranking.
+*/
+typedef struct stream_reader{
+    FILE *file; /**< the file */
+    char *buffer; /**< a chunk of the file */
+    size_t size; /**< number of bytes of the buffer */
+    size_t start; /**< position of the first unread byte in the buffer */
+    size_t end; /**< number of bytes read into the buffer */
+    long long offset; /**< offset in the file of the first byte of the buffer */
+    int eof; /**< 1 if the end of the file has been reached */
+} stream_reader;
+
+/**
+A structure that stores a chunk of a table file parsed by load_table(), the chunk starts at the beginning of a line and ends after a line break or at the end of the file.
+*/
+typedef struct table_chunk{
+    char *start; /**< first byte of the chunk */
+    char *end; /**< byte after the last byte of the chunk */
+    long lines; /**< number of lines of the chunk including empty ones */
+    int rows; /**< number of rows of the chunk which are not empty */
+    int first_row; /**< number of rows before the chunk */
+    long first_line; /**< line of the file (from 1) of the first line of the chunk */
+    long field_line; /**< line of the first row with an incorrect number of values, 0 if there is none */
+    long fields; /**< number of values of the row field_line */
+    long long format_position; /**< position (from 0, row by row) of the first value which is not a number, -1 if there is none */
+} table_chunk;
+
+/**
+A structure that stores the state shared by the tasks of load_table().
+*/
+typedef struct table_context{
+    table_chunk *chunks; /**< chunks of the file */
+    dataset *data; /**< dataset filled with the values */
+    char delimiter; /**< separator of fields */
+    char **name; /**< first character of the name of every observation in the mapped file */
+    int *name_length; /**< length of the name of every observation */
+} table_context;
+
+/**
+A structure that stores a pool of threads, which run tasks numbered from 0 to count-1 until all of them are completed.
+*/
+struct thread_pool{
+    int threads; /**< number of threads including the thread calling thread_pool_run() */
+    pthread_t *workers; /**< threads-1 worker threads */
+    pthread_mutex_t lock; /**< mutex guarding the fields below */
+    pthread_cond_t start; /**< signalled when new tasks are available or the pool is stopped */
+    pthread_cond_t finish; /**< signalled when the last worker has finished its tasks */
+    void (*task)(void *context, int i, int thread); /**< function running the task i on a given thread */
+    void *context; /**< pointer passed to the task function */
+    int count; /**< number of tasks */
+    int next; /**< next task to be taken */
+    int pending; /**< number of workers which have not finished yet */
+    int generation; /**< incremented for every call of thread_pool_run() */
+    int stop; /**< 1 if worker threads have to exit */
+};
+
+/**
+A function that takes 4 parameters and returns an error code, which is also stored with the name of the file in the details of an error if they are not NULL.
+*/
+static int set_error(aoimo_error *error, int code, const char *file_name, int system_error){
+    if(error!=NULL){
+        error->code = code;
+        error->file_name = file_name;
+        error->system_error = system_error;
+    }
+    return code;
+}
+
+/**
+A function that takes 3 parameters and returns an error code of making room for count more names of the given number of bytes (zero bytes included) in a table of names.
+*/
+static int string_table_reserve(string_table *table, int count, size_t size){
+    size_t capacity;
+    void *memory;
+
+    if(table->count+count>table->capacity){
+        capacity = (size_t)table->capacity*2>(size_t)table->count+count ? (size_t)table->capacity*2 : (size_t)table->count+count;
+        if(capacity>0x7fffffff){
+            return AOIMO_MEMORY_ERROR;
+        }
+        memory = realloc(table->offset, capacity*sizeof(size_t));
+        if(memory==NULL){
+            return AOIMO_MEMORY_ERROR;
+        }
+        table->offset = memory;
+        memory = realloc(table->length, capacity*sizeof(int));
+        if(memory==NULL){
+            return AOIMO_MEMORY_ERROR;
+        }
+        table->length = memory;
+        table->capacity = (int)capacity;
+    }
+    if(table->size+size>table->arena_capacity){
+        capacity = table->arena_capacity*2>table->size+size ? table->arena_capacity*2 : table->size+size;
+        memory = realloc(table->arena, capacity);
+        if(memory==NULL){
+            return AOIMO_MEMORY_ERROR;
+        }
+        table->arena = memory;
+        table->arena_capacity = capacity;
+    }
+    return AOIMO_OK;
+}
+
+int string_table_add(string_table *table, const char *name, size_t length){
+    if(length>0x7fffffff || string_table_reserve(table, 1, length+1)!=AOIMO_OK){
+        return AOIMO_MEMORY_ERROR;
+    }
+    memcpy(table->arena+table->size, name, length);
+    table->arena[table->size+length] = '\0';
+    table->offset[table->count] = table->size;
+    table->length[table->count] = (int)length;
+    table->size += length+1;
+    table->count++;
+    return AOIMO_OK;
+}
+
+int string_table_split(string_table *table, const char *text, size_t size, int count){
+    char *line, *end, *next;
+    int i;
+
+    if(string_table_reserve(table, count, size+count)!=AOIMO_OK){
+        return AOIMO_MEMORY_ERROR;
+    }
+    line = table->arena+table->size;
+    memcpy(line, text, size);
+    end = line+size;
+    for(i=0; i<count; i++){
+        next = line<end ? memchr(line, '\n', end-line) : NULL;
+        if(next==NULL){
+            next = line<end ? end : line;
+        }
+        *next = '\0';
+        table->offset[table->count+i] = line-table->arena;
+        table->length[table->count+i] = (int)(next-line);
+        line = next+1;
+    }
+    table->size = line-table->arena;
+    table->count += count;
+    return AOIMO_OK;
+}
+
+/**
+A function that takes 2 parameters and returns an error code of adding all names of a source table at the end of a table of names.
+*/
+static int string_table_append(string_table *table, const string_table *source){
+    int i;
+
+    if(string_table_reserve(table, source->count, source->size)!=AOIMO_OK){
+        return AOIMO_MEMORY_ERROR;
+    }
+    memcpy(table->arena+table->size, source->arena, source->size);
+    for(i=0; i<source->count; i++){
+        table->offset[table->count+i] = table->size+source->offset[i];
+        table->length[table->count+i] = source->length[i];
+    }
+    table->size += source->size;
+    table->count += source->count;
+    return AOIMO_OK;
+}
+
+const char *string_table_get(const string_table *table, int id){
+    return table->arena+table->offset[id];
+}
+
+void string_table_clear(string_table *table){
+    table->count = 0;
+    table->size = 0;
+}
+
+void string_table_free(string_table *table){
+    free(table->arena);
+    free(table->offset);
+    free(table->length);
+    memset(table, 0, sizeof(*table));
+}
+
+/**
+A function that takes 2 parameters and returns the number of lines of a text, 0 if the text is empty.
+*/
+static int count_lines(const char *text, size_t size){
+    const char *end = text+size;
+    long long lines = size>0;
+
+    while(text<end && (text = memchr(text, '\n', end-text))!=NULL){
+        lines++;
+        text++;
+    }
+    return lines>0x7fffffff ? 0x7fffffff : (int)lines;
+}
+
+dataset *dataset_create(int observation_number, int variables_number){
+    dataset *data = malloc(sizeof(dataset));
+
+    if(data==NULL){
+        return NULL;
+    }
+    memset(&data->observation, 0, sizeof(data->observation));
+    memset(&data->variable, 0, sizeof(data->variable));
+    data->values = NULL;
+    data->mapping.data = NULL;
+    data->mapping.size = 0;
+    data->values_capacity = 0;
+    data->observation_number = 0;
+    data->variables_number = 0;
+    if(dataset_resize(data, observation_number, variables_number)!=AOIMO_OK){
+        dataset_free(data);
+        return NULL;
+    }
+    return data;
+}
+
+int dataset_resize(dataset *data, int observation_number, int variables_number){
+    size_t size = (size_t)observation_number*variables_number;
+
+    if(data->mapping.data!=NULL){
+        unmap_file(&data->mapping);
+        data->values = NULL;
+        data->values_capacity = 0;
+    }
+    string_table_clear(&data->observation);
+    string_table_clear(&data->variable);
+    if(size>data->values_capacity){
+        free(data->values);
+        data->values = malloc(size*sizeof(double));
+        data->values_capacity = data->values==NULL ? 0 : size;
+    }
+    if(size>data->values_capacity){
+        data->observation_number = 0;
+        data->variables_number = 0;
+        return AOIMO_MEMORY_ERROR;
+    }
+    data->observation_number = observation_number;
+    data->variables_number = variables_number;
+    return AOIMO_OK;
+}
+
+dataset *dataset_from_arrays(int observation_number, int variables_number, const double values[], const char *const observation[], const char *const variable[]){
+    dataset *data = dataset_create(observation_number, variables_number);
+    const char *name;
+    int i, failed = 0;
+
+    if(data==NULL){
+        return NULL;
+    }
+    memcpy(data->values, values, (size_t)observation_number*variables_number*sizeof(double));
+    for(i=0; i<observation_number; i++){
+        name = observation!=NULL && observation[i]!=NULL ? observation[i] : "";
+        failed |= string_table_add(&data->observation, name, strlen(name));
+    }
+    for(i=0; i<variables_number; i++){
+        name = variable!=NULL && variable[i]!=NULL ? variable[i] : "";
+        failed |= string_table_add(&data->variable, name, strlen(name));
+    }
+    if(failed){
+        dataset_free(data);
+        return NULL;
+    }
+    return data;
+}
+
+void dataset_free(dataset *data){
+    if(data==NULL){
+        return;
+    }
+    string_table_free(&data->observation);
+    string_table_free(&data->variable);
+    if(data->mapping.data!=NULL){
+        unmap_file(&data->mapping);
+    }
+    else{
+        free(data->values);
+    }
+    free(data);
+}
+
+double *dataset_column(dataset *data, int i){
+    return data->values+(size_t)i*data->observation_number;
+}
+
+int load_dataset(dataset *data, const char *observations_database, const char *variables_database, const char *data_database, aoimo_error *error){
+    int observation_number, variables_number, code;
+    mapped_file mapped_observations, mapped_variables, mapped_data;
+
+    code = map_file(observations_database, &mapped_observations, error);
+    if(code!=AOIMO_OK){
+        return code;
+    }
+    code = map_file(variables_database, &mapped_variables, error);
+    if(code!=AOIMO_OK){
+        unmap_file(&mapped_observations);
+        return code;
+    }
+    observation_number = count_lines(mapped_observations.data, mapped_observations.size);
+    variables_number = count_lines(mapped_variables.data, mapped_variables.size);
+
+    code = map_file(data_database, &mapped_data, error);
+    if(code==AOIMO_OK){
+        code = dataset_resize(data, observation_number, variables_number);
+        if(code==AOIMO_OK){
+            code = string_table_split(&data->observation, mapped_observations.data, mapped_observations.size, observation_number);
+        }
+        if(code==AOIMO_OK){
+            code = string_table_split(&data->variable, mapped_variables.data, mapped_variables.size, variables_number);
+        }
+        code = set_error(error, code, NULL, 0);
+        if(code==AOIMO_OK){
+            code = load_data(&mapped_data, data, error);
+            if(error!=NULL && code!=AOIMO_OK){
+                error->file_name = data_database;
+            }
+        }
+        unmap_file(&mapped_data);
+    }
+    unmap_file(&mapped_observations);
+    unmap_file(&mapped_variables);
+    return code;
+}
+
+int dataset_save_cache(dataset *data, const char *file_name, aoimo_error *error){
+    static const char padding[CACHE_ALIGNMENT] = {0};
+    cache_header header;
+    long long names_size = 0;
+    int i;
+    FILE *file = fopen(file_name, "wb");
+
+    if(file==NULL){
+        return set_error(error, AOIMO_EXISTENCE_ERROR, file_name, errno);
+    }
+    for(i=0; i<data->observation_number; i++){
+        names_size += data->observation.length[i]+1;
+    }
+    for(i=0; i<data->variables_number; i++){
+        names_size += data->variable.length[i]+1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "AOIMOBIN", 8);
+    header.byte_order = 0x01020304;
+    header.version = CACHE_VERSION;
+    header.observation_number = data->observation_number;
+    header.variables_number = data->variables_number;
+    header.names_offset = sizeof(header);
+    header.names_size = names_size;
+    header.values_offset = (header.names_offset+names_size+CACHE_ALIGNMENT-1)/CACHE_ALIGNMENT*CACHE_ALIGNMENT;
+
+    fwrite(&header, sizeof(header), 1, file);
+    for(i=0; i<data->observation_number; i++){
+        fwrite(string_table_get(&data->observation, i), data->observation.length[i]+1, 1, file);
+    }
+    for(i=0; i<data->variables_number; i++){
+        fwrite(string_table_get(&data->variable, i), data->variable.length[i]+1, 1, file);
+    }
+    fwrite(padding, header.values_offset-header.names_offset-names_size, 1, file);
+    fwrite(data->values, sizeof(double), (size_t)data->observation_number*data->variables_number, file);
+    if(ferror(file) | fclose(file)){
+        return set_error(error, AOIMO_EXISTENCE_ERROR, file_name, errno);
+    }
+    return set_error(error, AOIMO_OK, NULL, 0);
+}
+
+/**
+A function that takes 2 parameters and returns 1 if the header of a binary cache file is correct and the file is complete, otherwise 0.
+*/
+static int cache_valid(const cache_header *header, size_t size){
+    if(memcmp(header->magic, "AOIMOBIN", 8)!=0 || header->byte_order!=0x01020304 || header->version!=CACHE_VERSION){
+        return 0;
+    }
+    if(header->observation_number<=0 || header->variables_number<=0 || header->observation_number>0x7fffffff || header->variables_number>0x7fffffff){
+        return 0;
+    }
+    if(header->observation_number*header->variables_number>0x7fffffff){
+        return 0;
+    }
+    if(header->names_offset<(long long)sizeof(cache_header) || header->names_size<0 || header->names_offset+header->names_size>header->values_offset){
+        return 0;
+    }
+    return header->values_offset%CACHE_ALIGNMENT==0 && (unsigned long long)header->values_offset+header->observation_number*header->variables_number*sizeof(double)<=size;
+}
+
+int dataset_load_cache(dataset **data, const char *file_name, aoimo_error *error){
+    mapped_file mapped;
+    cache_header header;
+    char *name, *end, *next;
+    int i, code;
+
+    *data = NULL;
+    code = map_file(file_name, &mapped, error);
+    if(code!=AOIMO_OK){
+        return code;
+    }
+    if(mapped.size<sizeof(header)){
+        unmap_file(&mapped);
+        return set_error(error, AOIMO_CACHE_FORMAT_ERROR, file_name, 0);
+    }
+    memcpy(&header, mapped.data, sizeof(header));
+    if(!cache_valid(&header, mapped.size)){
+        unmap_file(&mapped);
+        return set_error(error, AOIMO_CACHE_FORMAT_ERROR, file_name, 0);
+    }
+
+    *data = dataset_create(0, 0);
+    if(*data==NULL){
+        unmap_file(&mapped);
+        return set_error(error, AOIMO_MEMORY_ERROR, file_name, 0);
+    }
+    (*data)->observation_number = header.observation_number;
+    (*data)->variables_number = header.variables_number;
+    (*data)->values = (double*)(mapped.data+header.values_offset);
+    (*data)->mapping = mapped;
+
+    name = mapped.data+header.names_offset;
+    end = name+header.names_size;
+    code = AOIMO_OK;
+    for(i=0; i<header.observation_number+header.variables_number && code==AOIMO_OK; i++){
+        next = name<end ? memchr(name, '\0', end-name) : NULL;
+        if(next==NULL){
+            code = AOIMO_CACHE_FORMAT_ERROR;
+        }
+        else{
+            code = string_table_add(i<header.observation_number ? &(*data)->observation : &(*data)->variable, name, next-name);
+            name = next+1;
+        }
+    }
+    if(code!=AOIMO_OK){
+        dataset_free(*data);
+        *data = NULL;
+        return set_error(error, code, file_name, 0);
+    }
+    return set_error(error, AOIMO_OK, NULL, 0);
+}
+
+/**
+A function that takes 4 parameters and returns the sum of values in a block, the minimum and maximum value of the block are stored in *minimum and *maximum.
+*/
+static double block_sum(const double *values, int n, double *minimum, double *maximum){
+    double sum = 0, low = values[0], high = values[0];
+    int j = 0;
+
+#if defined(__AVX__)
+    if(n>=4){
+        __m256d vsum = _mm256_setzero_pd(), vlow = _mm256_loadu_pd(values), vhigh = vlow;
+        double lane[4];
+        for(; j+4<=n; j+=4){
+            __m256d x = _mm256_loadu_pd(values+j);
+            vsum = _mm256_add_pd(vsum, x);
+            vlow = _mm256_min_pd(vlow, x);
+            vhigh = _mm256_max_pd(vhigh, x);
+        }
+        _mm256_storeu_pd(lane, vsum);
+        sum = (lane[0]+lane[1])+(lane[2]+lane[3]);
+        _mm256_storeu_pd(lane, vlow);
+        low = fmin(fmin(lane[0], lane[1]), fmin(lane[2], lane[3]));
+        _mm256_storeu_pd(lane, vhigh);
+        high = fmax(fmax(lane[0], lane[1]), fmax(lane[2], lane[3]));
+    }
+#elif defined(__SSE2__)
+    if(n>=2){
+        __m128d vsum = _mm_setzero_pd(), vlow = _mm_loadu_pd(values), vhigh = vlow;
+        double lane[2];
+        for(; j+2<=n; j+=2){
+            __m128d x = _mm_loadu_pd(values+j);
+            vsum = _mm_add_pd(vsum, x);
+            vlow = _mm_min_pd(vlow, x);
+            vhigh = _mm_max_pd(vhigh, x);
+        }
+        _mm_storeu_pd(lane, vsum);
+        sum = lane[0]+lane[1];
+        _mm_storeu_pd(lane, vlow);
+        low = fmin(lane[0], lane[1]);
+        _mm_storeu_pd(lane, vhigh);
+        high = fmax(lane[0], lane[1]);
+    }
+#endif
+    for(; j<n; j++){
+        sum += values[j];
+        if(values[j]<low){
+            low = values[j];
+        }
+        if(values[j]>high){
+            high = values[j];
+        }
+    }
+    *minimum = low;
+    *maximum = high;
+    return sum;
+}
+
+/**
+A function that takes 3 parameters and returns the sum of squared differences between values in a block and the mean value of the block.
+*/
+static double block_squared_deviation(const double *values, int n, double mean){
+    double sum = 0, difference;
+    int j = 0;
+
+#if defined(__AVX__)
+    if(n>=4){
+        __m256d vsum = _mm256_setzero_pd(), vmean = _mm256_set1_pd(mean);
+        double lane[4];
+        for(; j+4<=n; j+=4){
+            __m256d x = _mm256_sub_pd(_mm256_loadu_pd(values+j), vmean);
+            vsum = _mm256_add_pd(vsum, _mm256_mul_pd(x, x));
+        }
+        _mm256_storeu_pd(lane, vsum);
+        sum = (lane[0]+lane[1])+(lane[2]+lane[3]);
+    }
+#elif defined(__SSE2__)
+    if(n>=2){
+        __m128d vsum = _mm_setzero_pd(), vmean = _mm_set1_pd(mean);
+        double lane[2];
+        for(; j+2<=n; j+=2){
+            __m128d x = _mm_sub_pd(_mm_loadu_pd(values+j), vmean);
+            vsum = _mm_add_pd(vsum, _mm_mul_pd(x, x));
+        }
+        _mm_storeu_pd(lane, vsum);
+        sum = lane[0]+lane[1];
+    }
+#endif
+    for(; j<n; j++){
+        difference = values[j]-mean;
+        sum += difference*difference;
+    }
+    return sum;
+}
+
+void f_statistics(dataset *data, int i, statistics *result){
+    double *column = dataset_column(data, i);
+    double mean = 0, squared_deviation = 0, block_mean, block_minimum, block_maximum, delta;
+    double count = 0, total;
+    int j, n;
+
+    result->minimum = column[0];
+    result->maximum = column[0];
+    for(j=0; j<data->observation_number; j+=STATISTICS_BLOCK){
+        n = data->observation_number-j < STATISTICS_BLOCK ? data->observation_number-j : STATISTICS_BLOCK;
+        block_mean = block_sum(column+j, n, &block_minimum, &block_maximum)/n;
+        if(block_minimum<result->minimum){
+            result->minimum = block_minimum;
+        }
+        if(block_maximum>result->maximum){
+            result->maximum = block_maximum;
+        }
+
+        total = count+n;
+        delta = block_mean-mean;
+        mean += delta*n/total;
+        squared_deviation += block_squared_deviation(column+j, n, block_mean)+delta*delta*count*n/total;
+        count = total;
+    }
+    result->mean = mean;
+    result->variance = squared_deviation/data->observation_number;
+    result->standard_deviation = sqrt(result->variance);
+    result->coeff_of_variation = f_coeff_of_variation(result->mean, result->standard_deviation);
+}
+
+/**
+A function that takes 2 parameters and compares 2 double values for qsort().
+*/
+static int compare_values(const void *a, const void *b){
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x>y)-(x<y);
+}
+
+/**
+A function that takes 2 parameters and compares 2 integer values for qsort().
+*/
+static int compare_ranks(const void *a, const void *b){
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x>y)-(x<y);
+}
+
+/**
+A function that takes 6 parameters and places the values of the given sorted ranks of values[left..right] in their sorted positions.
+\param values[] - a double array to be partially ordered
+\param left - an integer first position of the range
+\param right - an integer last position of the range
+\param ranks[rank_count] - an ascending integer array of ranks within the range
+\param rank_count - an integer number of ranks
+\param depth - an integer number of partitions left before the range is sorted
+*/
+static void select_ranks(double values[], int left, int right, const int ranks[], int rank_count, int depth){
+    double pivot, temp, a, b, c;
+    int lower, upper, j, k, split;
+
+    while(rank_count>0 && right-left>SELECTION_CUTOFF){
+        if(depth--==0){
+            qsort(values+left, right-left+1, sizeof(double), compare_values);
+            return;
+        }
+        a = values[left];
+        b = values[left+(right-left)/2];
+        c = values[right];
+        pivot = a<b ? (b<c ? b : (a<c ? c : a)) : (a<c ? a : (b<c ? c : b));
+
+        lower = left;
+        upper = right;
+        j = left;
+        while(j<=upper){
+            if(values[j]<pivot){
+                temp = values[lower];
+                values[lower++] = values[j];
+                values[j++] = temp;
+            }
+            else if(values[j]>pivot){
+                temp = values[upper];
+                values[upper--] = values[j];
+                values[j] = temp;
+            }
+            else{
+                j++;
+            }
+        }
+
+        for(split=0; split<rank_count && ranks[split]<lower; split++);
+        for(k=split; k<rank_count && ranks[k]<=upper; k++);
+        select_ranks(values, left, lower-1, ranks, split, depth);
+        ranks += k;
+        rank_count -= k;
+        left = upper+1;
+    }
+    if(rank_count>0){
+        for(j=left+1; j<=right; j++){
+            temp = values[j];
+            for(k=j; k>left && values[k-1]>temp; k--){
+                values[k] = values[k-1];
+            }
+            values[k] = temp;
+        }
+    }
+}
+
+/**
+A function that takes 5 parameters and computes quantiles of n values, which are in their ordered positions at least at the positions needed by the quantiles.
+*/
+static void interpolate_quantiles(const double values[], int n, const double probabilities[], int count, double quantiles[]){
+    int position, j;
+    double h;
+
+    for(j=0; j<count; j++){
+        h = (n-1)*probabilities[j];
+        position = (int)h;
+        h -= position;
+        quantiles[j] = position+1<n && h>0 ? (1-h)*values[position]+h*values[position+1] : values[position];
+    }
+}
+
+/**
+A function that takes 5 parameters and returns an error code of computing quantiles of n values, which are partially ordered in place.
+*/
+static int select_quantiles(double values[], int n, const double probabilities[], int count, double quantiles[]){
+    int local[2*(DECILES+2)];
+    int *ranks = count<=DECILES+2 ? local : malloc(2*(size_t)count*sizeof(int));
+    int rank_count = 0, depth = 0, j, position;
+
+    if(ranks==NULL){
+        return AOIMO_MEMORY_ERROR;
+    }
+    for(j=0; j<count; j++){
+        position = (int)((n-1)*probabilities[j]);
+        ranks[rank_count++] = position;
+        if(position+1<n){
+            ranks[rank_count++] = position+1;
+        }
+    }
+    qsort(ranks, rank_count, sizeof(int), compare_ranks);
+    for(j=n; j>1; j/=2){
+        depth += 2;
+    }
+    select_ranks(values, 0, n-1, ranks, rank_count, depth);
+    if(ranks!=local){
+        free(ranks);
+    }
+    interpolate_quantiles(values, n, probabilities, count, quantiles);
+    return AOIMO_OK;
+}
+
+int f_quantiles(dataset *data, double data_copy[], int i, const double probabilities[], int count, double quantiles[]){
+    memcpy(data_copy, dataset_column(data, i), data->observation_number*sizeof(double));
+    return select_quantiles(data_copy, data->observation_number, probabilities, count, quantiles);
+}
+
+/**
+An array of orders of the deciles and quartiles computed by f_distribution().
+*/
+static const double distribution_probabilities[DECILES+2] = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 0.25, 0.75};
+
+/**
+A function that takes 2 parameters and stores the deciles and quartiles of orders distribution_probabilities in the statistics of a variable.
+*/
+static void store_distribution(const double quantiles[], statistics *result){
+    int j;
+
+    for(j=0; j<DECILES; j++){
+        result->decile[j] = quantiles[j];
+    }
+    result->median = quantiles[4];
+    result->quartile_1 = quantiles[DECILES];
+    result->quartile_3 = quantiles[DECILES+1];
+    result->interquartile_range = result->quartile_3-result->quartile_1;
+}
+
+void f_distribution(dataset *data, double data_copy[], int i, statistics *result){
+    double quantiles[DECILES+2];
+
+    f_quantiles(data, data_copy, i, distribution_probabilities, DECILES+2, quantiles);
+    store_distribution(quantiles, result);
+}
+
+double f_coeff_of_variation(double mean, double standard_deviation){
+    double coeff_of_var = fabs(standard_deviation/mean*100);
+    return coeff_of_var;
+}
+
+double f_scale(dataset *data, statistics stats[], int i, int j){
+    double scaled_value = (dataset_column(data, i)[j]-stats[i].mean)/stats[i].standard_deviation;
+    return scaled_value;
+}
+
+void ranking_f_mean(dataset *data, int first, int last, double ranking_mean_result[]){
+    double *column;
+    int i, j;
+
+    for(i=first; i<last; i++){
+        ranking_mean_result[i]=0;
+    }
+    for(j=0; j<data->variables_number;j++){
+        column = dataset_column(data, j);
+        for(i=first; i<last; i++){
+            ranking_mean_result[i]+=column[i];
+        }
+    }
+    for(i=first; i<last; i++){
+        ranking_mean_result[i]/=data->variables_number;
+    }
+}
+
+double ranking_f_minimum(double ranking_mean_result[], int n){
+    double minimum = ranking_mean_result[0];
+    int i;
+
+    for(i=1;i<n;i++){
+        if(ranking_mean_result[i]<minimum){
+            minimum=ranking_mean_result[i];
+        }
+    }
+    return minimum;
+}
+
+double ranking_f_maximum(double ranking_mean_result[], int n){
+    double maximum = ranking_mean_result[0];
+    int i;
+
+    for(i=1; i<n;i++){
+        if(ranking_mean_result[i]>maximum){
+            maximum=ranking_mean_result[i];
+        }
+    }
+    return maximum;
+}
+
+double ranking_f_index(double ranking_mean_result[], double ranking_minimum_result, double ranking_maximum_result, int i){
+    double index;
+
+    index=(ranking_mean_result[i]-ranking_minimum_result)/(ranking_maximum_result - ranking_minimum_result);
+
+    return index;
+}
+
+int map_file(const char *file_name, mapped_file *mapped, aoimo_error *error){
+    struct stat status;
+    void *data;
+    FILE *file = fopen(file_name, "r");
+
+    mapped->data = NULL;
+    mapped->size = 0;
+    if(file==NULL){
+        return set_error(error, AOIMO_EXISTENCE_ERROR, file_name, errno);
+    }
+    if(fstat(fileno(file), &status)!=0 || status.st_size==0){
+        fclose(file);
+        return set_error(error, AOIMO_EMPTY_FILE_ERROR, file_name, 0);
+    }
+    data = mmap(NULL, status.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fileno(file), 0);
+    fclose(file);
+    if(data==MAP_FAILED){
+        return set_error(error, AOIMO_MEMORY_ERROR, file_name, 0);
+    }
+    posix_madvise(data, status.st_size, POSIX_MADV_SEQUENTIAL);
+    mapped->data = data;
+    mapped->size = status.st_size;
+    return set_error(error, AOIMO_OK, NULL, 0);
+}
+
+int file_hash(const char *file_name, unsigned long long *hash, aoimo_error *error){
+    mapped_file mapped;
+    unsigned long long word, result;
+    size_t i;
+    int code = map_file(file_name, &mapped, error);
+
+    if(code!=AOIMO_OK){
+        return code;
+    }
+    result = 0x9e3779b97f4a7c15ULL^mapped.size;
+    for(i=0; i+8<=mapped.size; i+=8){
+        memcpy(&word, mapped.data+i, 8);
+        result = (result^word)*0xff51afd7ed558ccdULL;
+        result ^= result>>32;
+    }
+    word = 0;
+    memcpy(&word, mapped.data+i, mapped.size-i);
+    result = (result^word)*0xff51afd7ed558ccdULL;
+    result ^= result>>33;
+    result *= 0xc4ceb9fe1a85ec53ULL;
+    *hash = result^(result>>33);
+    unmap_file(&mapped);
+    return AOIMO_OK;
+}
+
+void unmap_file(mapped_file *mapped){
+    munmap(mapped->data, mapped->size);
+    mapped->data = NULL;
+    mapped->size = 0;
+}
+
+/**
+A function that takes 3 parameters and parses a number from the characters between start and end, it returns 1 when the whole token is a number, otherwise 0.
+Plain decimal numbers with up to 19 significant digits and a small exponent are converted exactly with a single multiplication or division, other numbers are passed to strtod() (a token longer than MEMORY-1 characters is copied to the heap first, so numbers of any length are accepted).
+*/
+static int parse_value(const char *start, const char *end, double *value){
+    static const double power[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char *p = start;
+    unsigned long long mantissa = 0;
+    int negative = 0, digits = 0, significant = 0, exponent = 0, exponent_value = 0, exponent_negative = 0, valid;
+    char buffer[MEMORY], *copy, *rest;
+
+    if(p<end && (*p=='-' || *p=='+')){
+        negative = *p++=='-';
+    }
+    for(; p<end && *p>='0' && *p<='9'; p++, digits++){
+        if(significant<19){
+            mantissa = mantissa*10+(*p-'0');
+            significant += mantissa>0;
+        }
+        else{
+            exponent++;
+        }
+    }
+    if(p<end && *p=='.'){
+        for(p++; p<end && *p>='0' && *p<='9'; p++, digits++){
+            if(significant<19){
+                mantissa = mantissa*10+(*p-'0');
+                significant += mantissa>0;
+                exponent--;
+            }
+        }
+    }
+    if(digits>0 && p<end && (*p=='e' || *p=='E')){
+        p++;
+        if(p<end && (*p=='-' || *p=='+')){
+            exponent_negative = *p++=='-';
+        }
+        if(p==end || *p<'0' || *p>'9'){
+            return 0;
+        }
+        for(; p<end && *p>='0' && *p<='9' && exponent_value<10000; p++){
+            exponent_value = exponent_value*10+(*p-'0');
+        }
+        exponent += exponent_negative ? -exponent_value : exponent_value;
+    }
+    if(digits>0 && p==end && mantissa<=(1ULL<<53) && exponent>=-22 && exponent<=22){
+        *value = exponent<0 ? mantissa/power[-exponent] : mantissa*power[exponent];
+        if(negative){
+            *value = -*value;
+        }
+        return 1;
+    }
+
+    copy = end-start<MEMORY ? buffer : malloc(end-start+1);
+    if(copy==NULL){
+        return 0;
+    }
+    memcpy(copy, start, end-start);
+    copy[end-start] = '\0';
+    *value = strtod(copy, &rest);
+    valid = rest!=copy && *rest=='\0';
+    if(copy!=buffer){
+        free(copy);
+    }
+    return valid;
+}
+
+int load_data(mapped_file *mapped, dataset *data, aoimo_error *error){
+    const char *p = mapped->data, *end = mapped->data+mapped->size, *token;
+    long capacity = (long)data->observation_number*data->variables_number;
+    long position = 0, first_error = -1;
+    int line_has_value = 0;
+    double value;
+
+    while(p<end){
+        if(*p=='\n'){
+            if(!line_has_value){
+                if(first_error<0){
+                    first_error = position;
+                }
+                position++;
+            }
+            line_has_value = 0;
+            p++;
+        }
+        else if(*p==' ' || *p=='\t' || *p=='\r' || *p=='\v' || *p=='\f'){
+            p++;
+        }
+        else{
+            token = p;
+            while(p<end && *p!='\n' && *p!=' ' && *p!='\t' && *p!='\r' && *p!='\v' && *p!='\f'){
+                p++;
+            }
+            if(!parse_value(token, p, &value)){
+                if(first_error<0){
+                    first_error = position;
+                }
+            }
+            else if(position<capacity){
+                data->values[position] = value;
+            }
+            position++;
+            line_has_value = 1;
+        }
+    }
+
+    if(position!=capacity){
+        if(error!=NULL){
+            error->observation_number = data->observation_number;
+            error->variables_number = data->variables_number;
+            error->data_number = position;
+        }
+        return set_error(error, AOIMO_DATA_ERROR, NULL, 0);
+    }
+    if(first_error>=0){
+        if(error!=NULL){
+            error->position = first_error+1;
+        }
+        return set_error(error, AOIMO_DATA_FORMAT_ERROR, NULL, 0);
+    }
+    return set_error(error, AOIMO_OK, NULL, 0);
+}
+
+/**
+A function that takes 3 parameters and returns a pointer to the end of a line which starts at a given byte, a line break at the end of the line and a carriage return before it are not included, *next is set to the first byte of the next line.
+*/
+static char *table_line(char *line, char *end, char **next){
+    char *line_end = memchr(line, '\n', end-line);
+
+    *next = line_end==NULL ? end : line_end+1;
+    if(line_end==NULL){
+        line_end = end;
+    }
+    if(line_end>line && line_end[-1]=='\r'){
+        line_end--;
+    }
+    return line_end;
+}
+
+/**
+A function that takes 5 parameters and returns a pointer to the separator or the end of the line after a field of a table file starting at a given byte, a quoted field is unquoted in place, *field and *length are set to the contents of the field.
+*/
+static char *table_field(char *p, char *line_end, char delimiter, char **field, size_t *length){
+    char *write;
+
+    if(p<line_end && *p=='"'){
+        write = p;
+        *field = p;
+        for(p++; p<line_end; p++){
+            if(*p=='"'){
+                if(p+1<line_end && p[1]=='"'){
+                    p++;
+                }
+                else{
+                    p++;
+                    break;
+                }
+            }
+            *write++ = *p;
+        }
+        *length = write-*field;
+        while(p<line_end && *p!=delimiter){
+            p++;
+        }
+        return p;
+    }
+    *field = p;
+    while(p<line_end && *p!=delimiter){
+        p++;
+    }
+    *length = p-*field;
+    return p;
+}
+
+/**
+A function that takes 3 parameters and counts the lines and the rows which are not empty of a chunk of a table file.
+*/
+static void table_count_task(void *context, int i, int thread){
+    table_chunk *chunk = &((table_context*)context)->chunks[i];
+    char *line = chunk->start, *line_end, *next;
+
+    (void)thread;
+    chunk->lines = 0;
+    chunk->rows = 0;
+    while(line<chunk->end){
+        line_end = table_line(line, chunk->end, &next);
+        chunk->lines++;
+        chunk->rows += line_end>line;
+        line = next;
+    }
+}
+
+/**
+A function that takes 3 parameters and parses the rows of a chunk of a table file into the columns of the dataset.
+*/
+static void table_parse_task(void *context, int i, int thread){
+    table_context *table = context;
+    table_chunk *chunk = &table->chunks[i];
+    dataset *data = table->data;
+    int n = data->observation_number, m = data->variables_number, row = chunk->first_row, j;
+    long line_number = chunk->first_line;
+    char *line = chunk->start, *line_end, *next, *p, *field;
+    size_t length;
+    double value;
+
+    (void)thread;
+    chunk->field_line = 0;
+    chunk->format_position = -1;
+    for(; line<chunk->end; line = next, line_number++){
+        line_end = table_line(line, chunk->end, &next);
+        if(line_end==line){
+            continue;
+        }
+        p = table_field(line, line_end, table->delimiter, &table->name[row], &length);
+        table->name_length[row] = (int)(length>0x7fffffff ? 0x7fffffff : length);
+        for(j=0; p<line_end; j++){
+            p = table_field(p+1, line_end, table->delimiter, &field, &length);
+            if(j>=m){
+                continue;
+            }
+            while(length>0 && *field==' '){
+                field++;
+                length--;
+            }
+            while(length>0 && field[length-1]==' '){
+                length--;
+            }
+            if(parse_value(field, field+length, &value)){
+                data->values[(size_t)j*n+row] = value;
+            }
+            else if(chunk->format_position<0){
+                chunk->format_position = (long long)row*m+j;
+            }
+        }
+        if(j!=m && chunk->field_line==0){
+            chunk->field_line = line_number;
+            chunk->fields = j;
+        }
+        row++;
+    }
+}
+
+int load_table(dataset *data, const char *file_name, thread_pool *pool, aoimo_error *error){
+    mapped_file mapped;
+    table_context table;
+    string_table header = {0};
+    char *line, *line_end, *next, *p, *field, *end;
+    size_t length;
+    int count, rows = 0, variables_number = 0, i, code;
+    long lines = 2;
+
+    code = map_file(file_name, &mapped, error);
+    if(code!=AOIMO_OK){
+        return code;
+    }
+    end = mapped.data+mapped.size;
+    line_end = table_line(mapped.data, end, &next);
+    table.delimiter = memchr(mapped.data, '\t', line_end-mapped.data)!=NULL ? '\t' : ',';
+    p = table_field(mapped.data, line_end, table.delimiter, &field, &length);
+    while(p<line_end && code==AOIMO_OK){
+        p = table_field(p+1, line_end, table.delimiter, &field, &length);
+        code = string_table_add(&header, field, length);
+        variables_number++;
+    }
+
+    count = 4*thread_pool_threads(pool);
+    if((size_t)(end-next)/TABLE_CHUNK+1<(size_t)count){
+        count = (int)((end-next)/TABLE_CHUNK+1);
+    }
+    table.chunks = malloc(count*sizeof(table_chunk));
+    table.data = data;
+    table.name = NULL;
+    table.name_length = NULL;
+    if(code!=AOIMO_OK || table.chunks==NULL){
+        code = AOIMO_MEMORY_ERROR;
+        count = 0;
+    }
+    line = next;
+    for(i=0; i<count; i++){
+        table.chunks[i].start = line;
+        line = i==count-1 ? end : next+(size_t)(end-next)*(i+1)/count;
+        if(line<table.chunks[i].start){
+            line = table.chunks[i].start;
+        }
+        if(line<end){
+            line = (p = memchr(line, '\n', end-line))==NULL ? end : p+1;
+        }
+        table.chunks[i].end = line;
+    }
+    thread_pool_run(pool, table_count_task, &table, count);
+    for(i=0; i<count; i++){
+        table.chunks[i].first_row = rows;
+        table.chunks[i].first_line = lines;
+        rows += table.chunks[i].rows;
+        lines += table.chunks[i].lines;
+    }
+
+    if(code==AOIMO_OK && (rows==0 || variables_number==0)){
+        code = rows==0 ? AOIMO_EMPTY_FILE_ERROR : AOIMO_FIELD_ERROR;
+        if(error!=NULL && variables_number==0){
+            error->position = 1;
+            error->variables_number = 0;
+            error->data_number = 0;
+        }
+    }
+    if(code==AOIMO_OK){
+        code = dataset_resize(data, rows, variables_number);
+    }
+    if(code==AOIMO_OK){
+        table.name = malloc((size_t)rows*sizeof(char*));
+        table.name_length = malloc((size_t)rows*sizeof(int));
+        code = string_table_append(&data->variable, &header);
+        if(table.name==NULL || table.name_length==NULL){
+            code = AOIMO_MEMORY_ERROR;
+        }
+    }
+    if(code==AOIMO_OK){
+        thread_pool_run(pool, table_parse_task, &table, count);
+        for(i=0; i<rows && code==AOIMO_OK; i++){
+            code = string_table_add(&data->observation, table.name[i], table.name_length[i]);
+        }
+    }
+    for(i=0; i<count && code==AOIMO_OK; i++){
+        if(table.chunks[i].field_line>0){
+            code = AOIMO_FIELD_ERROR;
+            if(error!=NULL){
+                error->position = table.chunks[i].field_line;
+                error->variables_number = variables_number;
+                error->data_number = table.chunks[i].fields;
+            }
+        }
+    }
+    for(i=0; i<count && code==AOIMO_OK; i++){
+        if(table.chunks[i].format_position>=0){
+            code = AOIMO_DATA_FORMAT_ERROR;
+            if(error!=NULL){
+                error->position = table.chunks[i].format_position+1;
+            }
+        }
+    }
+    free(table.chunks);
+    free(table.name);
+    free(table.name_length);
+    string_table_free(&header);
+    unmap_file(&mapped);
+    return set_error(error, code, code==AOIMO_OK || code==AOIMO_MEMORY_ERROR ? NULL : file_name, 0);
+}
+
+/**
+A function that takes 2 parameters and returns a positive value when the first position of the ranking is worse than the second one (lower index value or, for equal index values, higher observation ID), index values which are not a number are the worst.
+*/
+static int compare_entries(const void *a, const void *b){
+    const ranking_entry *x = a, *y = b;
+
+    if(x->index!=y->index){
+        if(isnan(x->index) || isnan(y->index)){
+            if(isnan(x->index)!=isnan(y->index)){
+                return isnan(x->index) ? 1 : -1;
+            }
+        }
+        else{
+            return x->index<y->index ? 1 : -1;
+        }
+    }
+    return (x->id>y->id)-(x->id<y->id);
+}
+
+/**
+A function that takes 3 parameters and restores the heap property of a heap of the worst positions of the ranking below a given position.
+*/
+static void sift_down(ranking_entry heap[], int size, int position){
+    ranking_entry temp;
+    int child;
+
+    while((child = 2*position+1)<size){
+        if(child+1<size && compare_entries(&heap[child+1], &heap[child])>0){
+            child++;
+        }
+        if(compare_entries(&heap[child], &heap[position])<=0){
+            return;
+        }
+        temp = heap[child];
+        heap[child] = heap[position];
+        heap[position] = temp;
+        position = child;
+    }
+}
+
+int ranking_order(double ranking_index_result[], int n, int top, ranking_entry order[]){
+    ranking_entry entry;
+    int i;
+
+    if(top<=0 || top>=n){
+        for(i=0; i<n; i++){
+            order[i].index = ranking_index_result[i];
+            order[i].id = i;
+        }
+        qsort(order, n, sizeof(ranking_entry), compare_entries);
+        return n;
+    }
+
+    for(i=0; i<top; i++){
+        order[i].index = ranking_index_result[i];
+        order[i].id = i;
+    }
+    for(i=top/2-1; i>=0; i--){
+        sift_down(order, top, i);
+    }
+    for(i=top; i<n; i++){
+        entry.index = ranking_index_result[i];
+        entry.id = i;
+        if(compare_entries(&entry, &order[0])<0){
+            order[0] = entry;
+            sift_down(order, top, 0);
+        }
+    }
+    qsort(order, top, sizeof(ranking_entry), compare_entries);
+    return top;
+}
+
+/**
+A function that takes a parameter and runs tasks of the pool on the thread number thread until there are no more tasks.
+*/
+static void thread_pool_work(thread_pool *pool, int thread){
+    int i;
+
+    for(;;){
+        pthread_mutex_lock(&pool->lock);
+        i = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+        if(i>=pool->count){
+            return;
+        }
+        pool->task(pool->context, i, thread);
+    }
+}
+
+/**
+A structure that stores the arguments of a worker thread.
+*/
+typedef struct worker_argument{
+    thread_pool *pool; /**< pool of the worker */
+    int thread; /**< number of the worker thread */
+} worker_argument;
+
+/**
+A function that takes a parameter and runs the loop of a worker thread of the pool until the pool is stopped.
+*/
+static void *thread_pool_worker(void *argument){
+    worker_argument *worker = argument;
+    thread_pool *pool = worker->pool;
+    int thread = worker->thread, generation = 0;
+
+    free(worker);
+    for(;;){
+        pthread_mutex_lock(&pool->lock);
+        while(pool->generation==generation && !pool->stop){
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if(pool->stop){
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        thread_pool_work(pool, thread);
+
+        pthread_mutex_lock(&pool->lock);
+        if(--pool->pending==0){
+            pthread_cond_signal(&pool->finish);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+thread_pool *thread_pool_create(int threads){
+    thread_pool *pool = malloc(sizeof(thread_pool));
+    worker_argument *worker;
+    int i;
+
+    if(pool==NULL){
+        return NULL;
+    }
+    pool->workers = malloc(threads*sizeof(pthread_t));
+    if(pool->workers==NULL){
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->finish, NULL);
+    pool->count = pool->next = pool->pending = pool->generation = pool->stop = 0;
+    for(i=1; i<threads; i++){
+        worker = malloc(sizeof(worker_argument));
+        if(worker!=NULL){
+            worker->pool = pool;
+            worker->thread = i;
+            if(pthread_create(&pool->workers[i], NULL, thread_pool_worker, worker)==0){
+                continue;
+            }
+            free(worker);
+        }
+        pool->threads = i;
+        thread_pool_free(pool);
+        return NULL;
+    }
+    pool->threads = threads;
+    return pool;
+}
+
+int thread_pool_threads(thread_pool *pool){
+    return pool==NULL ? 1 : pool->threads;
+}
+
+void thread_pool_run(thread_pool *pool, void (*task)(void *context, int i, int thread), void *context, int count){
+    int i;
+
+    if(pool==NULL){
+        for(i=0; i<count; i++){
+            task(context, i, 0);
+        }
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->context = context;
+    pool->count = count;
+    pool->next = 0;
+    pool->pending = pool->threads-1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    thread_pool_work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while(pool->pending>0){
+        pthread_cond_wait(&pool->finish, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_free(thread_pool *pool){
+    int i;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for(i=1; i<pool->threads; i++){
+        pthread_join(pool->workers[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->finish);
+    free(pool->workers);
+    free(pool);
+}
+
+/**
+A function that takes 2 parameters and returns a value of a variable converted to a stimulant according to its setting.
+*/
+static double convert_value(const variable_setting *setting, double value){
+    if(setting->direction==AOIMO_DESTIMULANT){
+        return -value;
+    }
+    if(setting->direction==AOIMO_NOMINANT){
+        return -fabs(value-setting->target);
+    }
+    return value;
+}
+
+/**
+A function that takes 4 parameters and returns the mean of n values of a nominant converted to a stimulant, their standard deviation, minimum and maximum are stored in result[0], result[1] and result[2] (Welford's method, a single read of the values).
+*/
+static double nominant_statistics(const double *column, int n, const variable_setting *setting, double result[3]){
+    double mean = 0, squared_deviation = 0, value, delta;
+    int j;
+
+    result[1] = result[2] = convert_value(setting, column[0]);
+    for(j=0; j<n; j++){
+        value = convert_value(setting, column[j]);
+        delta = value-mean;
+        mean += delta/(j+1);
+        squared_deviation += delta*(value-mean);
+        if(value<result[1]){
+            result[1] = value;
+        }
+        if(value>result[2]){
+            result[2] = value;
+        }
+    }
+    result[0] = sqrt(squared_deviation/n);
+    return mean;
+}
+
+/**
+A function that takes 2 parameters and scales the variable i converted to a stimulant and multiplied by its normalized weight in a single pass over its column, the statistics of the values from the dataset are kept for the results file.
+*/
+static void scale_converted(computation *work, int i){
+    const variable_setting *setting = &work->settings[i];
+    statistics *stats = &work->stats[i];
+    double *column = dataset_column(work->data, i);
+    double mean = stats->mean, converted[3] = {stats->standard_deviation, stats->minimum, stats->maximum}, factor;
+    int n = work->data->observation_number, j;
+
+    if(setting->direction==AOIMO_NOMINANT){
+        mean = nominant_statistics(column, n, setting, converted);
+        factor = setting->weight*work->weight_factor/converted[0];
+        for(j=0; j<n; j++){
+            column[j] = (-fabs(column[j]-setting->target)-mean)*factor;
+        }
+    }
+    else{
+        factor = setting->weight*work->weight_factor/converted[0];
+        if(setting->direction==AOIMO_DESTIMULANT){
+            factor = -factor;
+            converted[1] = stats->maximum;
+            converted[2] = stats->minimum;
+        }
+        for(j=0; j<n; j++){
+            column[j] = (column[j]-mean)*factor;
+        }
+    }
+    stats->ideal = (converted[2]-mean)*factor;
+    stats->anti_ideal = (converted[1]-mean)*factor;
+}
+
+/**
+A function that takes 2 parameters and scales the variable i whose statistics are already computed and sets its ideal and anti-ideal scaled values, the settings are applied if they are given.
+*/
+static void scale_variable(computation *work, int i){
+    dataset *data = work->data;
+    statistics *stats = &work->stats[i];
+    double *column = dataset_column(data, i);
+    int j;
+
+    if(work->settings!=NULL){
+        scale_converted(work, i);
+        return;
+    }
+    for(j=0; j<data->observation_number; j++){
+        column[j]=f_scale(data, work->stats, i, j);
+    }
+    stats->ideal = (stats->maximum-stats->mean)/stats->standard_deviation;
+    stats->anti_ideal = (stats->minimum-stats->mean)/stats->standard_deviation;
+}
+
+/**
+A function that takes 3 parameters and computes statistics and quantiles of the variable i and scales it.
+*/
+static void variable_task(void *context, int i, int thread){
+    computation *work = context;
+
+    f_statistics(work->data, i, &work->stats[i]);
+    f_distribution(work->data, work->data_copy+(size_t)thread*work->data->observation_number, i, &work->stats[i]);
+    scale_variable(work, i);
+}
+
+/**
+A function that takes 3 parameters and scales the variable i.
+*/
+static void scaling_task(void *context, int i, int thread){
+    (void)thread;
+    scale_variable(context, i);
+}
+
+/**
+A function that takes 3 parameters and computes the mean values of the block i of observations.
+*/
+static void mean_task(void *context, int i, int thread){
+    computation *work = context;
+    int last = (i+1)*ROW_BLOCK < work->data->observation_number ? (i+1)*ROW_BLOCK : work->data->observation_number;
+
+    (void)thread;
+    ranking_f_mean(work->data, i*ROW_BLOCK, last, work->ranking_mean_result);
+}
+
+/**
+A function that takes 3 parameters and computes the index values of the block i of observations.
+*/
+static void index_task(void *context, int i, int thread){
+    computation *work = context;
+    int last = (i+1)*ROW_BLOCK < work->data->observation_number ? (i+1)*ROW_BLOCK : work->data->observation_number;
+    int j;
+
+    (void)thread;
+    for(j=i*ROW_BLOCK; j<last; j++){
+        work->ranking_index_result[j]=ranking_f_index(work->ranking_mean_result, work->ranking_minimum_result, work->ranking_maximum_result, j);
+    }
+}
+
+/**
+A function that takes 4 parameters and adds the squared differences between n values of a scaled variable and the value of a pattern to the squared distances of observations.
+*/
+static void add_squared_distance(const double *column, int n, double pattern, double distance[]){
+    double difference;
+    int j = 0;
+
+#if defined(__AVX__)
+    __m256d vpattern = _mm256_set1_pd(pattern);
+    for(; j+4<=n; j+=4){
+        __m256d x = _mm256_sub_pd(_mm256_loadu_pd(column+j), vpattern);
+        _mm256_storeu_pd(distance+j, _mm256_add_pd(_mm256_loadu_pd(distance+j), _mm256_mul_pd(x, x)));
+    }
+#elif defined(__SSE2__)
+    __m128d vpattern = _mm_set1_pd(pattern);
+    for(; j+2<=n; j+=2){
+        __m128d x = _mm_sub_pd(_mm_loadu_pd(column+j), vpattern);
+        _mm_storeu_pd(distance+j, _mm_add_pd(_mm_loadu_pd(distance+j), _mm_mul_pd(x, x)));
+    }
+#endif
+    for(; j<n; j++){
+        difference = column[j]-pattern;
+        distance[j] += difference*difference;
+    }
+}
+
+/**
+A function that takes 3 parameters and computes the distances of the block i of observations to the pattern of development (the best scaled value of every variable) for the Hellwig method.
+*/
+static void hellwig_task(void *context, int i, int thread){
+    computation *work = context;
+    dataset *data = work->data;
+    int first = i*ROW_BLOCK, last = (i+1)*ROW_BLOCK < data->observation_number ? (i+1)*ROW_BLOCK : data->observation_number;
+    double *distance = work->ranking_mean_result;
+    int j;
+
+    (void)thread;
+    for(j=first; j<last; j++){
+        distance[j] = 0;
+    }
+    for(j=0; j<data->variables_number; j++){
+        add_squared_distance(dataset_column(data, j)+first, last-first, work->stats[j].ideal, distance+first);
+    }
+    for(j=first; j<last; j++){
+        distance[j] = sqrt(distance[j]);
+    }
+}
+
+/**
+A function that takes 3 parameters and computes the distances of the block i of observations to the ideal and anti-ideal solution (the best and the worst scaled value of every variable) and the index values for the TOPSIS method.
+*/
+static void topsis_task(void *context, int i, int thread){
+    computation *work = context;
+    dataset *data = work->data;
+    int first = i*ROW_BLOCK, last = (i+1)*ROW_BLOCK < data->observation_number ? (i+1)*ROW_BLOCK : data->observation_number;
+    double *ideal = work->ranking_mean_result, *anti_ideal = work->ranking_index_result, *column;
+    int j;
+
+    (void)thread;
+    for(j=first; j<last; j++){
+        ideal[j] = 0;
+        anti_ideal[j] = 0;
+    }
+    for(j=0; j<data->variables_number; j++){
+        column = dataset_column(data, j)+first;
+        add_squared_distance(column, last-first, work->stats[j].ideal, ideal+first);
+        add_squared_distance(column, last-first, work->stats[j].anti_ideal, anti_ideal+first);
+    }
+    for(j=first; j<last; j++){
+        ideal[j] = sqrt(ideal[j]);
+        anti_ideal[j] = sqrt(anti_ideal[j]);
+        anti_ideal[j] = anti_ideal[j]/(ideal[j]+anti_ideal[j]);
+    }
+}
+
+/**
+A function that takes 2 parameters and compares 2 pairs of a value and an observation ID by the value for qsort(), values which are not a number are greater than all other values.
+*/
+static int compare_pairs(const void *a, const void *b){
+    double x = ((const ranking_entry*)a)->index, y = ((const ranking_entry*)b)->index;
+
+    if(isnan(x) || isnan(y)){
+        return isnan(x)-isnan(y);
+    }
+    return (x>y)-(x<y);
+}
+
+/**
+A function that takes 3 parameters and adds the ranks of observations in the variable i (from 1 for the lowest value, equal values get the mean of their ranks) to the sums of ranks of the thread.
+Ranks and their sums are multiples of 0.5, so they are exact and do not depend on the order in which threads add them.
+*/
+static void rank_task(void *context, int i, int thread){
+    computation *work = context;
+    int n = work->data->observation_number, first, last, j;
+    ranking_entry *pairs = work->sort_copy+(size_t)thread*n;
+    double *rank_sum = work->data_copy+(size_t)thread*n, *column = dataset_column(work->data, i);
+
+    for(j=0; j<n; j++){
+        pairs[j].index = column[j];
+        pairs[j].id = j;
+    }
+    qsort(pairs, n, sizeof(ranking_entry), compare_pairs);
+    for(first=0; first<n; first=last){
+        for(last=first+1; last<n && compare_pairs(&pairs[first], &pairs[last])==0; last++);
+        for(j=first; j<last; j++){
+            rank_sum[pairs[j].id] += (first+last+1)/2.0;
+        }
+    }
+}
+
+/**
+A function that takes 2 parameters and returns the number of variables divided by the sum of their weights, 1 if there are no settings.
+*/
+static double weight_factor(const variable_setting settings[], int variables_number){
+    double sum = 0;
+    int j;
+
+    if(settings==NULL){
+        return 1;
+    }
+    for(j=0; j<variables_number; j++){
+        sum += settings[j].weight;
+    }
+    return variables_number/sum;
+}
+
+void compute_ranking(computation *work, thread_pool *pool){
+    work->weight_factor = weight_factor(work->settings, work->data->variables_number);
+    thread_pool_run(pool, variable_task, work, work->data->variables_number);
+    compute_method(work, pool, AOIMO_SUM_METHOD);
+}
+
+void compute_scaling(computation *work, thread_pool *pool){
+    work->weight_factor = weight_factor(work->settings, work->data->variables_number);
+    thread_pool_run(pool, scaling_task, work, work->data->variables_number);
+}
+
+void compute_scores(computation *work, thread_pool *pool, int method){
+    int n = work->data->observation_number, blocks = (n+ROW_BLOCK-1)/ROW_BLOCK;
+    int threads = thread_pool_threads(pool), i, t;
+    double mean = 0, squared_deviation = 0, pattern_distance;
+
+    if(method==AOIMO_HELLWIG_METHOD){
+        thread_pool_run(pool, hellwig_task, work, blocks);
+        for(i=0; i<n; i++){
+            mean += work->ranking_mean_result[i];
+        }
+        mean /= n;
+        for(i=0; i<n; i++){
+            squared_deviation += (work->ranking_mean_result[i]-mean)*(work->ranking_mean_result[i]-mean);
+        }
+        pattern_distance = mean+2*sqrt(squared_deviation/n);
+        for(i=0; i<n; i++){
+            work->ranking_index_result[i] = 1-work->ranking_mean_result[i]/pattern_distance;
+        }
+    }
+    else if(method==AOIMO_TOPSIS_METHOD){
+        thread_pool_run(pool, topsis_task, work, blocks);
+    }
+    else{
+        if(method==AOIMO_RANK_METHOD){
+            memset(work->data_copy, 0, (size_t)threads*n*sizeof(double));
+            thread_pool_run(pool, rank_task, work, work->data->variables_number);
+            for(i=0; i<n; i++){
+                work->ranking_mean_result[i] = work->data_copy[i];
+                for(t=1; t<threads; t++){
+                    work->ranking_mean_result[i] += work->data_copy[(size_t)t*n+i];
+                }
+                work->ranking_mean_result[i] /= work->data->variables_number;
+            }
+        }
+        else{
+            thread_pool_run(pool, mean_task, work, blocks);
+        }
+        work->ranking_minimum_result = ranking_f_minimum(work->ranking_mean_result, n);
+        work->ranking_maximum_result = ranking_f_maximum(work->ranking_mean_result, n);
+        thread_pool_run(pool, index_task, work, blocks);
+    }
+    work->method = method;
+}
+
+void compute_method(computation *work, thread_pool *pool, int method){
+    compute_scores(work, pool, method);
+    work->positions = ranking_order(work->ranking_index_result, work->data->observation_number, work->top, work->order);
+}
+
+int computation_reserve(computation *work, dataset *data, int threads, int top){
+    work->data = data;
+    work->top = top;
+    if(data->observation_number>work->observation_capacity || threads>work->threads_capacity){
+        free(work->data_copy);
+        free(work->sort_copy);
+        work->data_copy = malloc((size_t)threads*data->observation_number*sizeof(double));
+        work->sort_copy = malloc((size_t)threads*data->observation_number*sizeof(ranking_entry));
+        work->threads_capacity = work->data_copy==NULL || work->sort_copy==NULL ? 0 : threads;
+    }
+    if(data->observation_number>work->observation_capacity){
+        free(work->ranking_mean_result);
+        free(work->ranking_index_result);
+        free(work->order);
+        work->ranking_mean_result = malloc(data->observation_number*sizeof(double));
+        work->ranking_index_result = malloc(data->observation_number*sizeof(double));
+        work->order = malloc(data->observation_number*sizeof(ranking_entry));
+        work->observation_capacity = data->observation_number;
+    }
+    if(data->variables_number>work->variables_capacity){
+        free(work->stats);
+        work->stats = malloc(data->variables_number*sizeof(statistics));
+        work->variables_capacity = data->variables_number;
+    }
+    if(work->data_copy==NULL || work->sort_copy==NULL || work->ranking_mean_result==NULL || work->ranking_index_result==NULL || work->order==NULL || work->stats==NULL){
+        computation_free(work);
+        memset(work, 0, sizeof(*work));
+        return AOIMO_MEMORY_ERROR;
+    }
+    return AOIMO_OK;
+}
+
+void computation_free(computation *work){
+    free(work->data_copy);
+    free(work->sort_copy);
+    free(work->ranking_mean_result);
+    free(work->ranking_index_result);
+    free(work->order);
+    free(work->stats);
+}
+
+/**
+A function that takes 3 parameters and returns the length of the next word of a line separated by spaces or tabs, *token is set to its first character and *p after its last one, 0 if there are no more words.
+*/
+static size_t next_word(const char **p, const char *end, const char **token){
+    while(*p<end && (**p==' ' || **p=='\t' || **p=='\r')){
+        (*p)++;
+    }
+    *token = *p;
+    while(*p<end && **p!=' ' && **p!='\t' && **p!='\r'){
+        (*p)++;
+    }
+    return *p-*token;
+}
+
+/**
+A function that takes 2 parameters and returns 1 if a line of a settings file is correct and fills the setting of its variable, otherwise 0.
+*/
+static int parse_setting(const char *line, int length, variable_setting *setting){
+    static const char *directions[3] = {"stimulant", "destimulant", "nominant"};
+    const char *p = line, *end = line+length, *token;
+    size_t word = next_word(&p, end, &token);
+
+    for(setting->direction=0; setting->direction<3 && (word!=strlen(directions[setting->direction]) || memcmp(token, directions[setting->direction], word)!=0); setting->direction++);
+    if(setting->direction==3){
+        return 0;
+    }
+    setting->target = 0;
+    setting->weight = 1;
+    if(setting->direction==AOIMO_NOMINANT){
+        word = next_word(&p, end, &token);
+        if(!parse_value(token, token+word, &setting->target) || !isfinite(setting->target)){
+            return 0;
+        }
+    }
+    word = next_word(&p, end, &token);
+    if(word>0 && (!parse_value(token, token+word, &setting->weight) || !isfinite(setting->weight) || setting->weight<=0)){
+        return 0;
+    }
+    return next_word(&p, end, &token)==0;
+}
+
+int variable_settings_load(variable_setting settings[], const char *file_name, int variables_number, aoimo_error *error){
+    mapped_file mapped;
+    string_table lines = {0};
+    double sum = 0;
+    int code, j;
+
+    code = map_file(file_name, &mapped, error);
+    if(code!=AOIMO_OK){
+        return code;
+    }
+    code = string_table_split(&lines, mapped.data, mapped.size, count_lines(mapped.data, mapped.size));
+    unmap_file(&mapped);
+    for(j=0; j<variables_number && j<lines.count && code==AOIMO_OK; j++){
+        if(!parse_setting(string_table_get(&lines, j), lines.length[j], &settings[j])){
+            code = AOIMO_SETTINGS_ERROR;
+        }
+        else{
+            sum += settings[j].weight;
+        }
+    }
+    if(code==AOIMO_OK && (lines.count!=variables_number || !isfinite(sum))){
+        code = AOIMO_SETTINGS_ERROR;
+        j = lines.count<variables_number ? lines.count+1 : variables_number+(lines.count>variables_number);
+    }
+    if(code==AOIMO_SETTINGS_ERROR && error!=NULL){
+        error->position = j;
+    }
+    string_table_free(&lines);
+    return set_error(error, code, code==AOIMO_SETTINGS_ERROR ? file_name : NULL, 0);
+}
+
+/**
+A function that takes 3 parameters and returns the array reallocated to a given size, if it cannot be reallocated it returns the original array and sets *failed to 1.
+*/
+static void *grow_array(void *array, size_t size, int *failed){
+    void *result = realloc(array, size);
+
+    if(result==NULL){
+        *failed = 1;
+        return array;
+    }
+    return result;
+}
+
+/**
+A function that takes 3 parameters and returns an error code of enlarging an incremental ranking to a given number of rows and IDs, the capacity is at least doubled.
+*/
+static int incremental_reserve(incremental *engine, int rows, int ids){
+    int m = engine->variables_number, failed = 0, capacity, j;
+    double *sorted;
+
+    if(rows>engine->row_capacity){
+        capacity = rows>2*engine->row_capacity ? rows : 2*engine->row_capacity;
+        sorted = malloc((size_t)capacity*m*sizeof(double));
+        if(sorted==NULL){
+            return AOIMO_MEMORY_ERROR;
+        }
+        engine->values = grow_array(engine->values, (size_t)capacity*m*sizeof(double), &failed);
+        engine->id = grow_array(engine->id, capacity*sizeof(int), &failed);
+        engine->score = grow_array(engine->score, capacity*sizeof(double), &failed);
+        engine->changed_row = grow_array(engine->changed_row, capacity, &failed);
+        engine->order = grow_array(engine->order, capacity*sizeof(ranking_entry), &failed);
+        if(failed){
+            free(sorted);
+            return AOIMO_MEMORY_ERROR;
+        }
+        for(j=0; engine->sorted!=NULL && j<m; j++){
+            memcpy(sorted+(size_t)j*capacity, engine->sorted+(size_t)j*engine->row_capacity, engine->observation_number*sizeof(double));
+        }
+        free(engine->sorted);
+        engine->sorted = sorted;
+        engine->row_capacity = capacity;
+    }
+    if(ids>engine->id_capacity){
+        capacity = ids>2*engine->id_capacity ? ids : 2*engine->id_capacity;
+        engine->row = grow_array(engine->row, capacity*sizeof(int), &failed);
+        if(failed){
+            return AOIMO_MEMORY_ERROR;
+        }
+        engine->id_capacity = capacity;
+    }
+    return AOIMO_OK;
+}
+
+int incremental_create(incremental **engine, dataset *data){
+    int n = data->observation_number, m = data->variables_number;
+    int failed = 0, i, j;
+    double *column, difference;
+    statistics stats;
+
+    *engine = calloc(1, sizeof(incremental));
+    if(*engine==NULL){
+        return AOIMO_MEMORY_ERROR;
+    }
+    (*engine)->variables_number = m;
+    (*engine)->shift = grow_array(NULL, m*sizeof(double), &failed);
+    (*engine)->sum = grow_array(NULL, m*sizeof(double), &failed);
+    (*engine)->sum_of_squares = grow_array(NULL, m*sizeof(double), &failed);
+    (*engine)->weight = grow_array(NULL, m*sizeof(double), &failed);
+    (*engine)->weight_change = grow_array(NULL, m*sizeof(double), &failed);
+    (*engine)->changed_column = grow_array(NULL, m*sizeof(int), &failed);
+    (*engine)->stats = grow_array(NULL, m*sizeof(statistics), &failed);
+    failed |= string_table_append(&(*engine)->variable, &data->variable);
+    failed |= string_table_append(&(*engine)->observation, &data->observation);
+    if(failed || incremental_reserve(*engine, n, n)!=AOIMO_OK){
+        incremental_free(*engine);
+        *engine = NULL;
+        return AOIMO_MEMORY_ERROR;
+    }
+
+    for(i=0; i<n; i++){
+        (*engine)->id[i] = i;
+        (*engine)->row[i] = i;
+        (*engine)->changed_row[i] = 1;
+    }
+    for(j=0; j<m; j++){
+        column = dataset_column(data, j);
+        f_statistics(data, j, &stats);
+        (*engine)->shift[j] = stats.mean;
+        (*engine)->sum[j] = 0;
+        (*engine)->sum_of_squares[j] = 0;
+        (*engine)->weight[j] = 0;
+        for(i=0; i<n; i++){
+            (*engine)->values[(size_t)i*m+j] = column[i];
+            difference = column[i]-stats.mean;
+            (*engine)->sum[j] += difference;
+            (*engine)->sum_of_squares[j] += difference*difference;
+        }
+    }
+    (*engine)->observation_number = n;
+    (*engine)->id_number = n;
+    (*engine)->sorted_changes = SORTED_CHANGES+1;
+    return AOIMO_OK;
+}
+
+void incremental_free(incremental *engine){
+    if(engine==NULL){
+        return;
+    }
+    free(engine->values);
+    free(engine->id);
+    free(engine->row);
+    string_table_free(&engine->observation);
+    string_table_free(&engine->variable);
+    free(engine->shift);
+    free(engine->sum);
+    free(engine->sum_of_squares);
+    free(engine->weight);
+    free(engine->weight_change);
+    free(engine->changed_column);
+    free(engine->score);
+    free(engine->changed_row);
+    free(engine->sorted);
+    free(engine->stats);
+    free(engine->order);
+    free(engine);
+}
+
+int incremental_find(incremental *engine, const char *name){
+    int i;
+
+    for(i=0; i<engine->id_number; i++){
+        if(engine->row[i]>=0 && strcmp(string_table_get(&engine->observation, i), name)==0){
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+A function that takes 2 parameters and compares 2 double values for qsort(), values which are not a number are greater than all other values.
+*/
+static int compare_sorted(const void *a, const void *b){
+    double x = *(const double*)a, y = *(const double*)b;
+
+    if(isnan(x) || isnan(y)){
+        return isnan(x)-isnan(y);
+    }
+    return (x>y)-(x<y);
+}
+
+/**
+A function that takes 4 parameters and adds a value of the variable j to the running sums and the n sorted values of an incremental ranking.
+*/
+static void add_value(incremental *engine, int j, double value, int n){
+    double difference = value-engine->shift[j];
+    double *sorted = engine->sorted+(size_t)j*engine->row_capacity;
+    int low = 0, high = n, middle;
+
+    engine->sum[j] += difference;
+    engine->sum_of_squares[j] += difference*difference;
+    if(engine->sorted_changes<=SORTED_CHANGES){
+        while(low<high){
+            middle = (low+high)/2;
+            if(compare_sorted(&sorted[middle], &value)<0){
+                low = middle+1;
+            }
+            else{
+                high = middle;
+            }
+        }
+        memmove(sorted+low+1, sorted+low, (n-low)*sizeof(double));
+        sorted[low] = value;
+    }
+}
+
+/**
+A function that takes 4 parameters and removes a value of the variable j from the running sums and the n sorted values of an incremental ranking.
+*/
+static void remove_value(incremental *engine, int j, double value, int n){
+    double difference = value-engine->shift[j];
+    double *sorted = engine->sorted+(size_t)j*engine->row_capacity;
+    int low = 0, high = n-1, middle;
+
+    engine->sum[j] -= difference;
+    engine->sum_of_squares[j] -= difference*difference;
+    if(engine->sorted_changes<=SORTED_CHANGES){
+        while(low<high){
+            middle = (low+high)/2;
+            if(compare_sorted(&sorted[middle], &value)<0){
+                low = middle+1;
+            }
+            else{
+                high = middle;
+            }
+        }
+        memmove(sorted+low, sorted+low+1, (n-low-1)*sizeof(double));
+    }
+}
+
+int incremental_insert(incremental *engine, const char *name, const double values[]){
+    int m = engine->variables_number, r = engine->observation_number, id = engine->id_number, j;
+
+    if(incremental_reserve(engine, r+1, id+1)!=AOIMO_OK || string_table_add(&engine->observation, name, strlen(name))!=AOIMO_OK){
+        return AOIMO_MEMORY_ERROR;
+    }
+    engine->sorted_changes++;
+    for(j=0; j<m; j++){
+        engine->values[(size_t)r*m+j] = values[j];
+        add_value(engine, j, values[j], r);
+    }
+    engine->id[r] = id;
+    engine->row[id] = r;
+    engine->changed_row[r] = 1;
+    engine->observation_number++;
+    engine->id_number++;
+    engine->changes++;
+    return AOIMO_OK;
+}
+
+int incremental_update(incremental *engine, int id, const double values[]){
+    int n = engine->observation_number, m = engine->variables_number, j;
+    double *row;
+
+    if(id<0 || id>=engine->id_number || engine->row[id]<0){
+        return AOIMO_OBSERVATION_ERROR;
+    }
+    engine->sorted_changes++;
+    row = engine->values+(size_t)engine->row[id]*m;
+    for(j=0; j<m; j++){
+        if(memcmp(&row[j], &values[j], sizeof(double))!=0){
+            remove_value(engine, j, row[j], n);
+            add_value(engine, j, values[j], n-1);
+            row[j] = values[j];
+        }
+    }
+    engine->changed_row[engine->row[id]] = 1;
+    engine->changes++;
+    return AOIMO_OK;
+}
+
+int incremental_delete(incremental *engine, int id){
+    int m = engine->variables_number, last = engine->observation_number-1, r, j;
+
+    if(id<0 || id>=engine->id_number || engine->row[id]<0){
+        return AOIMO_OBSERVATION_ERROR;
+    }
+    engine->sorted_changes++;
+    r = engine->row[id];
+    for(j=0; j<m; j++){
+        remove_value(engine, j, engine->values[(size_t)r*m+j], last+1);
+    }
+    if(r!=last){
+        memcpy(engine->values+(size_t)r*m, engine->values+(size_t)last*m, m*sizeof(double));
+        engine->id[r] = engine->id[last];
+        engine->row[engine->id[r]] = r;
+        engine->score[r] = engine->score[last];
+        engine->changed_row[r] = engine->changed_row[last];
+    }
+    engine->row[id] = -1;
+    engine->observation_number--;
+    engine->changes++;
+    return AOIMO_OK;
+}
+
+/**
+A function that takes a parameter and computes the running sums of an incremental ranking again from the values, with the current means as shifts, so rounding errors of many changes do not accumulate.
+*/
+static void incremental_resum(incremental *engine){
+    int n = engine->observation_number, m = engine->variables_number, i, j;
+    double *row, difference;
+
+    for(j=0; j<m; j++){
+        engine->shift[j] += engine->sum[j]/n;
+        engine->sum[j] = 0;
+        engine->sum_of_squares[j] = 0;
+    }
+    for(i=0; i<n; i++){
+        row = engine->values+(size_t)i*m;
+        for(j=0; j<m; j++){
+            difference = row[j]-engine->shift[j];
+            engine->sum[j] += difference;
+            engine->sum_of_squares[j] += difference*difference;
+        }
+    }
+    engine->changes = 0;
+}
+
+/**
+A function that takes 3 parameters and sorts again the values of the variable i of an incremental ranking.
+*/
+static void sort_task(void *context, int i, int thread){
+    incremental *engine = context;
+    int n = engine->observation_number, m = engine->variables_number, r;
+    double *sorted = engine->sorted+(size_t)i*engine->row_capacity;
+
+    (void)thread;
+    for(r=0; r<n; r++){
+        sorted[r] = engine->values[(size_t)r*m+i];
+    }
+    qsort(sorted, n, sizeof(double), compare_sorted);
+}
+
+/**
+A structure that stores the arguments of the tasks of incremental_refresh().
+*/
+typedef struct score_context{
+    incremental *engine; /**< incremental ranking */
+    int all; /**< 1 if all rows have to be scored, otherwise only changed rows */
+    int changed_columns; /**< number of variables whose weights changed, the scores of other rows are corrected for them */
+} score_context;
+
+/**
+A function that takes 3 parameters and computes the scores of the block i of rows of an incremental ranking.
+*/
+static void score_task(void *context, int i, int thread){
+    incremental *engine = ((score_context*)context)->engine;
+    int all = ((score_context*)context)->all, changed_columns = ((score_context*)context)->changed_columns, m = engine->variables_number, r, j, k;
+    int last = (i+1)*ROW_BLOCK < engine->observation_number ? (i+1)*ROW_BLOCK : engine->observation_number;
+    double *row, score;
+
+    (void)thread;
+    for(r=i*ROW_BLOCK; r<last; r++){
+        row = engine->values+(size_t)r*m;
+        if(all || engine->changed_row[r]){
+            score = 0;
+            for(j=0; j<m; j++){
+                score += (row[j]-engine->shift[j])*engine->weight[j];
+            }
+            engine->score[r] = score;
+            engine->changed_row[r] = 0;
+        }
+        else if(changed_columns>0){
+            score = engine->score[r];
+            for(k=0; k<changed_columns; k++){
+                j = engine->changed_column[k];
+                score += (row[j]-engine->shift[j])*engine->weight_change[j];
+            }
+            engine->score[r] = score;
+        }
+    }
+}
+
+/**
+A function that takes 2 parameters and sorts a nearly ordered ranking with insertion sort, if it needs more than REPAIR_MOVES moves per position the ranking is sorted with qsort() instead.
+*/
+static void repair_order(ranking_entry order[], int n){
+    long moves = 0, budget = (long)REPAIR_MOVES*n;
+    ranking_entry temp;
+    int i, k;
+
+    for(i=1; i<n; i++){
+        temp = order[i];
+        for(k=i; k>0 && compare_entries(&order[k-1], &temp)>0; k--){
+            order[k] = order[k-1];
+            if(++moves>budget){
+                order[k-1] = temp;
+                qsort(order, n, sizeof(ranking_entry), compare_entries);
+                return;
+            }
+        }
+        order[k] = temp;
+    }
+}
+
+void incremental_refresh(incremental *engine, thread_pool *pool){
+    int n = engine->observation_number, m = engine->variables_number, positions = 0, i, j;
+    double *sorted, mean, weight, quantiles[DECILES+2];
+    statistics *stats;
+    score_context context;
+
+    context.engine = engine;
+    context.all = 0;
+    context.changed_columns = 0;
+    if(n>0 && engine->changes>=n){
+        incremental_resum(engine);
+        context.all = 1;
+    }
+    if(engine->sorted_changes>SORTED_CHANGES){
+        thread_pool_run(pool, sort_task, engine, m);
+    }
+    engine->sorted_changes = 0;
+    for(j=0; j<m; j++){
+        stats = &engine->stats[j];
+        if(n==0){
+            for(i=0; i<DECILES+2; i++){
+                quantiles[i] = NAN;
+            }
+            store_distribution(quantiles, stats);
+            stats->mean = stats->variance = stats->standard_deviation = stats->coeff_of_variation = stats->minimum = stats->maximum = NAN;
+            continue;
+        }
+        sorted = engine->sorted+(size_t)j*engine->row_capacity;
+        mean = engine->sum[j]/n;
+        stats->mean = engine->shift[j]+mean;
+        stats->variance = engine->sum_of_squares[j]/n-mean*mean;
+        if(stats->variance<0){
+            stats->variance = 0;
+        }
+        stats->standard_deviation = sqrt(stats->variance);
+        stats->coeff_of_variation = f_coeff_of_variation(stats->mean, stats->standard_deviation);
+        stats->minimum = sorted[0];
+        stats->maximum = sorted[n-1];
+        interpolate_quantiles(sorted, n, distribution_probabilities, DECILES+2, quantiles);
+        store_distribution(quantiles, stats);
+
+        weight = 1/stats->standard_deviation;
+        if(memcmp(&weight, &engine->weight[j], sizeof(double))!=0){
+            engine->weight_change[j] = weight-engine->weight[j];
+            engine->weight[j] = weight;
+            engine->changed_column[context.changed_columns++] = j;
+            if(!isfinite(engine->weight_change[j])){
+                context.all = 1;
+            }
+        }
+    }
+    if(context.changed_columns==m){
+        context.all = 1;
+    }
+    thread_pool_run(pool, score_task, &context, (n+ROW_BLOCK-1)/ROW_BLOCK);
+
+    for(i=0; i<engine->positions; i++){
+        if(engine->row[engine->order[i].id]>=0){
+            engine->order[positions].id = engine->order[i].id;
+            engine->order[positions++].index = engine->score[engine->row[engine->order[i].id]];
+        }
+    }
+    for(i=engine->ranked_ids; i<engine->id_number; i++){
+        if(engine->row[i]>=0){
+            engine->order[positions].id = i;
+            engine->order[positions++].index = engine->score[engine->row[i]];
+        }
+    }
+    engine->positions = positions;
+    engine->ranked_ids = engine->id_number;
+    repair_order(engine->order, positions);
+
+    for(i=positions-1; i>0 && isnan(engine->order[i].index); i--);
+    engine->minimum_score = positions>0 ? engine->order[i].index : 0;
+    engine->maximum_score = positions>0 ? engine->order[0].index : 0;
+}
+
+double incremental_index(incremental *engine, int position){
+    return (engine->order[position].index-engine->minimum_score)/(engine->maximum_score-engine->minimum_score);
+}
+
+/**
+A structure that stores the buffers of a thread computing replicates of ranking_resample().
+*/
+typedef struct resample_buffers{
+    int *weight; /**< number of times every observation is drawn */
+    int *variable_weight; /**< number of times every variable is drawn */
+    double *score; /**< scores of observations */
+    ranking_entry *order; /**< ranking of observations */
+} resample_buffers;
+
+/**
+A structure that stores the arguments of the tasks of ranking_resample().
+*/
+typedef struct resample_context{
+    dataset *data; /**< resampled dataset */
+    const resampling *settings; /**< settings of the resampling */
+    resample_buffers *buffers; /**< buffers of every thread */
+    int *positions; /**< positions of observations in replicates */
+} resample_context;
+
+unsigned long long next_random(unsigned long long *state){
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+
+    z = (z^(z>>30))*0xBF58476D1CE4E5B9ULL;
+    z = (z^(z>>27))*0x94D049BB133111EBULL;
+    return z^(z>>31);
+}
+
+/**
+A function that takes 3 parameters and computes the positions of all observations in the ranking of the replicate b.
+*/
+static void resample_task(void *context, int b, int thread){
+    resample_context *task = context;
+    dataset *data = task->data;
+    resample_buffers *buffers = &task->buffers[thread];
+    int n = data->observation_number, m = data->variables_number, i, j;
+    unsigned long long state = b;
+    double *column, mean, squared_deviation, factor, drawn;
+
+    state = task->settings->seed^next_random(&state);
+    for(i=0; i<n; i++){
+        buffers->weight[i] = task->settings->jackknife ? i!=b : 0;
+        buffers->score[i] = 0;
+    }
+    for(j=0; j<m; j++){
+        buffers->variable_weight[j] = !task->settings->variables || task->settings->jackknife;
+    }
+    if(!task->settings->jackknife){
+        for(i=0; i<n; i++){
+            buffers->weight[(next_random(&state)>>32)*n>>32]++;
+        }
+        for(j=0; j<m && task->settings->variables; j++){
+            buffers->variable_weight[(next_random(&state)>>32)*m>>32]++;
+        }
+    }
+
+    drawn = task->settings->jackknife ? n-1 : n;
+    for(j=0; j<m; j++){
+        if(buffers->variable_weight[j]==0){
+            continue;
+        }
+        column = dataset_column(data, j);
+        mean = 0;
+        for(i=0; i<n; i++){
+            mean += buffers->weight[i]*column[i];
+        }
+        mean /= drawn;
+        squared_deviation = 0;
+        for(i=0; i<n; i++){
+            squared_deviation += buffers->weight[i]*(column[i]-mean)*(column[i]-mean);
+        }
+        factor = squared_deviation>0 ? buffers->variable_weight[j]/sqrt(squared_deviation/drawn) : 0;
+        for(i=0; i<n; i++){
+            buffers->score[i] += (column[i]-mean)*factor;
+        }
+    }
+
+    ranking_order(buffers->score, n, 0, buffers->order);
+    for(i=0; i<n; i++){
+        task->positions[(size_t)buffers->order[i].id*task->settings->replicates+b] = i+1;
+    }
+}
+
+int ranking_resample(dataset *data, thread_pool *pool, const resampling *settings, int positions[]){
+    int threads = thread_pool_threads(pool), n = data->observation_number, m = data->variables_number;
+    int code = AOIMO_OK, t;
+    resample_context context;
+
+    context.data = data;
+    context.settings = settings;
+    context.positions = positions;
+    context.buffers = calloc(threads, sizeof(resample_buffers));
+    if(context.buffers==NULL){
+        return AOIMO_MEMORY_ERROR;
+    }
+    for(t=0; t<threads; t++){
+        context.buffers[t].weight = malloc(n*sizeof(int));
+        context.buffers[t].variable_weight = malloc(m*sizeof(int));
+        context.buffers[t].score = malloc(n*sizeof(double));
+        context.buffers[t].order = malloc(n*sizeof(ranking_entry));
+        if(context.buffers[t].weight==NULL || context.buffers[t].variable_weight==NULL || context.buffers[t].score==NULL || context.buffers[t].order==NULL){
+            code = AOIMO_MEMORY_ERROR;
+        }
+    }
+    if(code==AOIMO_OK){
+        thread_pool_run(pool, resample_task, &context, settings->replicates);
+    }
+    for(t=0; t<threads; t++){
+        free(context.buffers[t].weight);
+        free(context.buffers[t].variable_weight);
+        free(context.buffers[t].score);
+        free(context.buffers[t].order);
+    }
+    free(context.buffers);
+    return code;
+}
+
+int resampling_percentiles(const int positions[], int observation_number, int replicates, const double probabilities[], int count, double percentiles[]){
+    double *copy = malloc(replicates*sizeof(double));
+    int code = AOIMO_OK, i, b;
+
+    if(copy==NULL){
+        return AOIMO_MEMORY_ERROR;
+    }
+    for(i=0; i<observation_number && code==AOIMO_OK; i++){
+        for(b=0; b<replicates; b++){
+            copy[b] = positions[(size_t)i*replicates+b];
+        }
+        code = select_quantiles(copy, replicates, probabilities, count, percentiles+(size_t)i*count);
+    }
+    free(copy);
+    return code;
+}
+
+/**
+A structure that stores the arguments of the tasks of ranking_sensitivity().
+*/
+typedef struct sensitivity_context{
+    computation *work; /**< computation with the scaled dataset and the sums of scaled values in ranking_mean_result */
+    int *positions; /**< positions of observations with all variables */
+    int *shifts; /**< changes of positions without every variable */
+} sensitivity_context;
+
+/**
+A function that takes 3 parameters and ranks observations without the variable i (or with all variables if i is variables_number) and stores their positions or changes of positions.
+*/
+static void sensitivity_task(void *context, int i, int thread){
+    sensitivity_context *task = context;
+    dataset *data = task->work->data;
+    int n = data->observation_number, m = data->variables_number, p;
+    ranking_entry *pairs = task->work->sort_copy+(size_t)thread*n;
+    double *column = i<m ? dataset_column(data, i) : NULL;
+
+    for(p=0; p<n; p++){
+        pairs[p].index = column!=NULL ? task->work->ranking_mean_result[p]*m-column[p] : task->work->ranking_mean_result[p];
+        pairs[p].id = p;
+    }
+    qsort(pairs, n, sizeof(ranking_entry), compare_entries);
+    for(p=0; p<n; p++){
+        if(column!=NULL){
+            task->shifts[(size_t)pairs[p].id*m+i] = p+1;
+        }
+        else{
+            task->positions[pairs[p].id] = p+1;
+        }
+    }
+}
+
+void ranking_sensitivity(computation *work, thread_pool *pool, int positions[], int shifts[]){
+    int n = work->data->observation_number, m = work->data->variables_number, i, j;
+    sensitivity_context context;
+
+    if(work->method!=AOIMO_SUM_METHOD){
+        compute_method(work, pool, AOIMO_SUM_METHOD);
+    }
+    context.work = work;
+    context.positions = positions;
+    context.shifts = shifts;
+    thread_pool_run(pool, sensitivity_task, &context, m+1);
+    for(i=0; i<n; i++){
+        for(j=0; j<m; j++){
+            shifts[(size_t)i*m+j] -= positions[i];
+        }
+    }
+}
+
+/**
+A structure that stores the state shared by the tasks of compute_groups().
+*/
+typedef struct group_context{
+    grouping *groups; /**< grouping of observations */
+    dataset *data; /**< dataset, it is not changed */
+    const variable_setting *settings; /**< directions and weights of variables, NULL if all variables are stimulants with equal weights */
+    double weight_factor; /**< number of variables divided by the sum of weights */
+} group_context;
+
+/**
+A function that takes 2 parameters and returns the FNV-1a hash of a key.
+*/
+static unsigned long long hash_key(const char *key, int length){
+    unsigned long long hash = 14695981039346656037ULL;
+    int i;
+
+    for(i=0; i<length; i++){
+        hash = (hash^(unsigned char)key[i])*1099511628211ULL;
+    }
+    return hash;
+}
+
+int grouping_create(grouping *groups, const string_table *keys, int observation_number, int top){
+    int *slot, size = 1, failed = 0, g, i, length;
+    const char *key;
+    unsigned long long position;
+
+    if(keys->count!=observation_number){
+        return AOIMO_GROUP_ERROR;
+    }
+    while(size<2*observation_number){
+        size *= 2;
+    }
+    memset(groups, 0, sizeof(*groups));
+    groups->observation_number = observation_number;
+    groups->top = top;
+    slot = malloc(size*sizeof(int));
+    groups->group = grow_array(NULL, observation_number*sizeof(int), &failed);
+    groups->member = grow_array(NULL, observation_number*sizeof(int), &failed);
+    groups->ranking_mean_result = grow_array(NULL, observation_number*sizeof(double), &failed);
+    groups->ranking_index_result = grow_array(NULL, observation_number*sizeof(double), &failed);
+    groups->order = grow_array(NULL, observation_number*sizeof(ranking_entry), &failed);
+    if(slot==NULL || failed){
+        free(slot);
+        grouping_free(groups);
+        return AOIMO_MEMORY_ERROR;
+    }
+    for(i=0; i<size; i++){
+        slot[i] = -1;
+    }
+    for(i=0; i<observation_number && !failed; i++){
+        key = string_table_get(keys, i);
+        length = keys->length[i];
+        position = hash_key(key, length)&(size-1);
+        while((g = slot[position])>=0 && (groups->name.length[g]!=length || memcmp(string_table_get(&groups->name, g), key, length)!=0)){
+            position = (position+1)&(size-1);
+        }
+        if(g<0){
+            g = slot[position] = groups->group_number++;
+            failed = string_table_add(&groups->name, key, length)!=AOIMO_OK;
+        }
+        groups->group[i] = g;
+    }
+    free(slot);
+    groups->first = grow_array(NULL, (groups->group_number+1)*sizeof(int), &failed);
+    groups->positions = grow_array(NULL, groups->group_number*sizeof(int), &failed);
+    if(failed){
+        grouping_free(groups);
+        return AOIMO_MEMORY_ERROR;
+    }
+    memset(groups->first, 0, (groups->group_number+1)*sizeof(int));
+    for(i=0; i<observation_number; i++){
+        groups->first[groups->group[i]+1]++;
+    }
+    for(g=0; g<groups->group_number; g++){
+        groups->first[g+1] += groups->first[g];
+        groups->positions[g] = groups->first[g];
+    }
+    for(i=0; i<observation_number; i++){
+        groups->member[groups->positions[groups->group[i]]++] = i;
+    }
+    return AOIMO_OK;
+}
+
+int grouping_load(grouping *groups, const char *file_name, int observation_number, int top, aoimo_error *error){
+    mapped_file mapped;
+    string_table keys = {0};
+    int code;
+
+    code = map_file(file_name, &mapped, error);
+    if(code!=AOIMO_OK){
+        return code;
+    }
+    code = string_table_split(&keys, mapped.data, mapped.size, count_lines(mapped.data, mapped.size));
+    unmap_file(&mapped);
+    if(code==AOIMO_OK){
+        code = grouping_create(groups, &keys, observation_number, top);
+    }
+    if(code==AOIMO_GROUP_ERROR && error!=NULL){
+        error->observation_number = observation_number;
+        error->data_number = keys.count;
+    }
+    string_table_free(&keys);
+    return set_error(error, code, code==AOIMO_GROUP_ERROR ? file_name : NULL, 0);
+}
+
+/**
+A function that takes 3 parameters and computes the mean and standard deviation of the variable i in every group with a single scan of its column (Welford's method).
+*/
+static void group_statistics_task(void *context, int i, int thread){
+    grouping *groups = ((group_context*)context)->groups;
+    const variable_setting *settings = ((group_context*)context)->settings;
+    const double *column = dataset_column(((group_context*)context)->data, i);
+    int m = groups->variables_number, *count = groups->count+(size_t)thread*groups->group_number, g, j;
+    double *mean = groups->mean_result+i, *squared_deviation = groups->sd_result+i, value, delta;
+
+    for(g=0; g<groups->group_number; g++){
+        count[g] = 0;
+        mean[(size_t)g*m] = 0;
+        squared_deviation[(size_t)g*m] = 0;
+    }
+    for(j=0; j<groups->observation_number; j++){
+        g = groups->group[j];
+        value = settings!=NULL ? convert_value(&settings[i], column[j]) : column[j];
+        count[g]++;
+        delta = value-mean[(size_t)g*m];
+        mean[(size_t)g*m] += delta/count[g];
+        squared_deviation[(size_t)g*m] += delta*(value-mean[(size_t)g*m]);
+    }
+    for(g=0; g<groups->group_number; g++){
+        squared_deviation[(size_t)g*m] = sqrt(squared_deviation[(size_t)g*m]/count[g]);
+    }
+}
+
+/**
+A function that takes 3 parameters and scales, scores and ranks the observations of the group g.
+*/
+static void group_rank_task(void *context, int g, int thread){
+    grouping *groups = ((group_context*)context)->groups;
+    dataset *data = ((group_context*)context)->data;
+    const variable_setting *settings = ((group_context*)context)->settings;
+    int m = groups->variables_number, first = groups->first[g], n = groups->first[g+1]-first, i, j;
+    const int *member = groups->member+first;
+    double *mean_result = groups->ranking_mean_result+first, *index_result = groups->ranking_index_result+first;
+    double mean, sd, minimum, maximum;
+    const double *column;
+    ranking_entry *order = groups->order+first;
+
+    (void)thread;
+    for(i=0; i<n; i++){
+        mean_result[i] = 0;
+    }
+    for(j=0; j<m; j++){
+        column = dataset_column(data, j);
+        mean = groups->mean_result[(size_t)g*m+j];
+        sd = groups->sd_result[(size_t)g*m+j];
+        if(settings!=NULL){
+            sd /= settings[j].weight*((group_context*)context)->weight_factor;
+            for(i=0; i<n; i++){
+                mean_result[i] += (convert_value(&settings[j], column[member[i]])-mean)/sd;
+            }
+            continue;
+        }
+        for(i=0; i<n; i++){
+            mean_result[i] += (column[member[i]]-mean)/sd;
+        }
+    }
+    for(i=0; i<n; i++){
+        mean_result[i] /= m;
+    }
+    minimum = ranking_f_minimum(mean_result, n);
+    maximum = ranking_f_maximum(mean_result, n);
+    for(i=0; i<n; i++){
+        index_result[i] = ranking_f_index(mean_result, minimum, maximum, i);
+    }
+    groups->positions[g] = ranking_order(index_result, n, groups->top, order);
+    for(i=0; i<groups->positions[g]; i++){
+        order[i].id = member[order[i].id];
+    }
+}
+
+int compute_groups(grouping *groups, dataset *data, const variable_setting settings[], thread_pool *pool){
+    group_context context;
+    int threads = thread_pool_threads(pool), failed = 0;
+
+    if(data->observation_number!=groups->observation_number){
+        return AOIMO_GROUP_ERROR;
+    }
+    if(data->variables_number>groups->variables_capacity){
+        groups->mean_result = grow_array(groups->mean_result, (size_t)groups->group_number*data->variables_number*sizeof(double), &failed);
+        groups->sd_result = grow_array(groups->sd_result, (size_t)groups->group_number*data->variables_number*sizeof(double), &failed);
+        if(failed){
+            return AOIMO_MEMORY_ERROR;
+        }
+        groups->variables_capacity = data->variables_number;
+    }
+    if(threads>groups->threads_capacity){
+        groups->count = grow_array(groups->count, (size_t)threads*groups->group_number*sizeof(int), &failed);
+        if(failed){
+            return AOIMO_MEMORY_ERROR;
+        }
+        groups->threads_capacity = threads;
+    }
+    groups->variables_number = data->variables_number;
+    context.groups = groups;
+    context.data = data;
+    context.settings = settings;
+    context.weight_factor = weight_factor(settings, data->variables_number);
+    thread_pool_run(pool, group_statistics_task, &context, data->variables_number);
+    thread_pool_run(pool, group_rank_task, &context, groups->group_number);
+    return AOIMO_OK;
+}
+
+void grouping_free(grouping *groups){
+    string_table_free(&groups->name);
+    free(groups->group);
+    free(groups->first);
+    free(groups->member);
+    free(groups->mean_result);
+    free(groups->sd_result);
+    free(groups->ranking_mean_result);
+    free(groups->ranking_index_result);
+    free(groups->order);
+    free(groups->positions);
+    free(groups->count);
+    memset(groups, 0, sizeof(*groups));
+}
+
+void quantile_sketch_init(quantile_sketch *sketch, int capacity){
+    int l;
+
+    for(l=0; l<QUANTILE_SKETCH_LEVELS; l++){
+        sketch->level[l] = NULL;
+        sketch->size[l] = 0;
+    }
+    sketch->levels = 0;
+    sketch->capacity = capacity;
+    sketch->parity = 0;
+    sketch->count = 0;
+}
+
+/**
+A function that takes 3 parameters and returns an error code of adding a value to a given level of a quantile sketch, a full level is sorted first and every second value is moved to the next level.
+*/
+static int sketch_insert(quantile_sketch *sketch, int l, double value){
+    int k, code;
+
+    if(sketch->level[l]==NULL){
+        sketch->level[l] = malloc(sketch->capacity*sizeof(double));
+        if(sketch->level[l]==NULL){
+            return AOIMO_MEMORY_ERROR;
+        }
+        sketch->levels = l+1>sketch->levels ? l+1 : sketch->levels;
+    }
+    if(sketch->size[l]==sketch->capacity){
+        if(l+1==QUANTILE_SKETCH_LEVELS){
+            return AOIMO_MEMORY_ERROR;
+        }
+        qsort(sketch->level[l], sketch->capacity, sizeof(double), compare_values);
+        for(k=sketch->parity; k<sketch->capacity; k+=2){
+            code = sketch_insert(sketch, l+1, sketch->level[l][k]);
+            if(code!=AOIMO_OK){
+                return code;
+            }
+        }
+        sketch->size[l] = 0;
+        sketch->parity ^= 1;
+    }
+    sketch->level[l][sketch->size[l]++] = value;
+    return AOIMO_OK;
+}
+
+int quantile_sketch_add(quantile_sketch *sketch, double value){
+    int code;
+
+    if(isnan(value)){
+        return AOIMO_OK;
+    }
+    code = sketch_insert(sketch, 0, value);
+    if(code==AOIMO_OK){
+        sketch->count++;
+    }
+    return code;
+}
+
+int quantile_sketch_merge(quantile_sketch *sketch, const quantile_sketch *other){
+    int l, k, code;
+
+    for(l=0; l<other->levels; l++){
+        for(k=0; k<other->size[l]; k++){
+            code = sketch_insert(sketch, l, other->level[l][k]);
+            if(code!=AOIMO_OK){
+                return code;
+            }
+        }
+    }
+    sketch->count += other->count;
+    return AOIMO_OK;
+}
+
+/**
+A structure that stores a value kept by a quantile sketch and the number of values it stands for.
+*/
+typedef struct weighted_value{
+    double value; /**< the value */
+    long long weight; /**< number of added values */
+} weighted_value;
+
+/**
+A function that takes 2 parameters and compares 2 weighted values by their values for qsort().
+*/
+static int compare_weighted(const void *a, const void *b){
+    return compare_values(&((const weighted_value*)a)->value, &((const weighted_value*)b)->value);
+}
+
+/**
+A function that takes 3 parameters and returns the value at a given rank (from 0) of the weighted values sorted by their values, the weights are replaced by the numbers of values up to and including every value.
+*/
+static double weighted_rank(const weighted_value values[], int n, long long rank){
+    int left = 0, right = n-1, middle;
+
+    while(left<right){
+        middle = left+(right-left)/2;
+        if(values[middle].weight>rank){
+            right = middle;
+        }
+        else{
+            left = middle+1;
+        }
+    }
+    return values[left].value;
+}
+
+int quantile_sketch_query(const quantile_sketch *sketch, const double probabilities[], int count, double quantiles[]){
+    weighted_value *values;
+    long long position, total = 0;
+    int l, k, n = 0, j;
+    double h, low, high;
+
+    if(sketch->count==0){
+        for(j=0; j<count; j++){
+            quantiles[j] = NAN;
+        }
+        return AOIMO_OK;
+    }
+    for(l=0; l<sketch->levels; l++){
+        n += sketch->size[l];
+    }
+    values = malloc(n*sizeof(weighted_value));
+    if(values==NULL){
+        return AOIMO_MEMORY_ERROR;
+    }
+    n = 0;
+    for(l=0; l<sketch->levels; l++){
+        for(k=0; k<sketch->size[l]; k++){
+            values[n].value = sketch->level[l][k];
+            values[n++].weight = 1LL<<l;
+        }
+    }
+    qsort(values, n, sizeof(weighted_value), compare_weighted);
+    for(k=0; k<n; k++){
+        total += values[k].weight;
+        values[k].weight = total;
+    }
+
+    for(j=0; j<count; j++){
+        h = (total-1)*probabilities[j];
+        position = (long long)h;
+        h -= position;
+        low = weighted_rank(values, n, position);
+        if(position+1<total && h>0){
+            high = weighted_rank(values, n, position+1);
+            quantiles[j] = (1-h)*low+h*high;
+        }
+        else{
+            quantiles[j] = low;
+        }
+    }
+    free(values);
+    return AOIMO_OK;
+}
+
+void quantile_sketch_free(quantile_sketch *sketch){
+    int l;
+
+    for(l=0; l<sketch->levels; l++){
+        free(sketch->level[l]);
+        sketch->level[l] = NULL;
+        sketch->size[l] = 0;
+    }
+    sketch->levels = 0;
+    sketch->count = 0;
+}
+
+/**
+A function that takes 2 parameters and makes a reader continue from a given offset of its file, it returns 0 on success.
+*/
+static int reader_seek(stream_reader *reader, long long offset){
+    reader->start = 0;
+    reader->end = 0;
+    reader->offset = offset;
+    reader->eof = 0;
+    return fseeko(reader->file, (off_t)offset, SEEK_SET);
+}
+
+/**
+A function that takes a parameter and moves the unread bytes of a reader to the beginning of its buffer and fills the rest of the buffer from the file.
+*/
+static void reader_fill(stream_reader *reader){
+    size_t length = reader->end-reader->start, got;
+
+    memmove(reader->buffer, reader->buffer+reader->start, length);
+    reader->offset += reader->start;
+    reader->start = 0;
+    got = fread(reader->buffer+length, 1, reader->size-length, reader->file);
+    reader->end = length+got;
+    if(got==0){
+        reader->eof = 1;
+    }
+}
+
+/**
+A function that takes 4 parameters and returns 1 if the next token of a reader is a value, 2 if it is a line break and 0 at the end of the file, the offset of the token in the file is stored.
+A value split between two chunks is completed by moving it to the beginning of the buffer before the next chunk is read.
+*/
+static int reader_next(stream_reader *reader, const char **token, size_t *length, long long *offset){
+    const char *buffer = reader->buffer;
+    size_t p;
+
+    for(;;){
+        if(reader->start==reader->end){
+            if(reader->eof){
+                return 0;
+            }
+            reader_fill(reader);
+        }
+        else if(buffer[reader->start]=='\n'){
+            *offset = reader->offset+reader->start++;
+            return 2;
+        }
+        else if(buffer[reader->start]==' ' || buffer[reader->start]=='\t' || buffer[reader->start]=='\r' || buffer[reader->start]=='\v' || buffer[reader->start]=='\f'){
+            reader->start++;
+        }
+        else{
+            for(p=reader->start; p<reader->end && buffer[p]!='\n' && buffer[p]!=' ' && buffer[p]!='\t' && buffer[p]!='\r' && buffer[p]!='\v' && buffer[p]!='\f'; p++);
+            if(p==reader->end && !reader->eof && (reader->start>0 || reader->end<reader->size)){
+                reader_fill(reader);
+                continue;
+            }
+            *token = buffer+reader->start;
+            *length = p-reader->start;
+            *offset = reader->offset+reader->start;
+            reader->start = p;
+            return 1;
+        }
+    }
+}
+
+/**
+A function that takes 5 parameters and merges a block of n values of a variable, which starts at the position first of the variable, into its minimum, maximum, mean and sum of squared deviations, with the same operations as f_statistics().
+*/
+static void merge_block(const double block[], int n, int first, statistics *result, double *squared_deviation){
+    double block_mean, block_minimum, block_maximum, delta, total = (double)first+n;
+
+    block_mean = block_sum(block, n, &block_minimum, &block_maximum)/n;
+    if(first==0){
+        result->minimum = block_minimum;
+        result->maximum = block_maximum;
+        result->mean = 0;
+        *squared_deviation = 0;
+    }
+    if(block_minimum<result->minimum){
+        result->minimum = block_minimum;
+    }
+    if(block_maximum>result->maximum){
+        result->maximum = block_maximum;
+    }
+    delta = block_mean-result->mean;
+    result->mean += delta*n/total;
+    *squared_deviation += block_squared_deviation(block, n, block_mean)+delta*delta*first*n/total;
+}
+
+int stream_open(stream **result, const char *observations_database, const char *variables_database, const char *data_database, aoimo_error *error){
+    stream *ranking;
+    stream_reader reader;
+    mapped_file mapped_observations, mapped_variables;
+    double block[STATISTICS_BLOCK], quantiles[DECILES+2], value, squared_deviation = 0;
+    const char *token;
+    size_t length;
+    long long offset, capacity, position = 0, first_error = -1;
+    int observation_number, variables_number, line_has_value = 0, kind, valid, size = 0, j, r, code = AOIMO_OK;
+    statistics *stats;
+
+    *result = NULL;
+    code = map_file(observations_database, &mapped_observations, error);
+    if(code!=AOIMO_OK){
+        return code;
+    }
+    observation_number = count_lines(mapped_observations.data, mapped_observations.size);
+    unmap_file(&mapped_observations);
+
+    code = map_file(variables_database, &mapped_variables, error);
+    if(code!=AOIMO_OK){
+        return code;
+    }
+    variables_number = count_lines(mapped_variables.data, mapped_variables.size);
+
+    ranking = calloc(1, sizeof(stream));
+    reader.buffer = malloc(STREAM_CHUNK);
+    if(ranking!=NULL){
+        ranking->observation_number = observation_number;
+        ranking->variables_number = variables_number;
+        ranking->blocks = (observation_number+STREAM_BLOCK-1)/STREAM_BLOCK;
+        ranking->observations_database = observations_database;
+        ranking->data_database = data_database;
+        code = string_table_split(&ranking->variable, mapped_variables.data, mapped_variables.size, variables_number);
+        ranking->stats = malloc(variables_number*sizeof(statistics));
+        ranking->sketches = calloc(variables_number, sizeof(quantile_sketch));
+        ranking->offsets = malloc((size_t)variables_number*ranking->blocks*sizeof(long long));
+    }
+    unmap_file(&mapped_variables);
+    if(ranking==NULL || code!=AOIMO_OK || ranking->stats==NULL || ranking->sketches==NULL || ranking->offsets==NULL || reader.buffer==NULL){
+        free(reader.buffer);
+        stream_close(ranking);
+        return set_error(error, AOIMO_MEMORY_ERROR, NULL, 0);
+    }
+    for(j=0; j<variables_number; j++){
+        quantile_sketch_init(&ranking->sketches[j], STREAM_SKETCH_CAPACITY);
+    }
+
+    reader.file = fopen(data_database, "rb");
+    reader.size = STREAM_CHUNK;
+    if(reader.file==NULL){
+        code = set_error(error, AOIMO_EXISTENCE_ERROR, data_database, errno);
+    }
+    else{
+        reader_seek(&reader, 0);
+        capacity = (long long)observation_number*variables_number;
+        while(code==AOIMO_OK && (kind = reader_next(&reader, &token, &length, &offset))!=0){
+            if(kind==2 && line_has_value){
+                line_has_value = 0;
+                continue;
+            }
+            valid = kind==1 && parse_value(token, token+length, &value);
+            if(!valid){
+                if(first_error<0){
+                    first_error = position;
+                }
+                value = 0;
+            }
+            line_has_value = kind==1;
+
+            if(position<capacity){
+                j = (int)(position/observation_number);
+                r = (int)(position%observation_number);
+                if(r%STREAM_BLOCK==0){
+                    ranking->offsets[(size_t)j*ranking->blocks+r/STREAM_BLOCK] = offset;
+                }
+                if(valid){
+                    code = set_error(error, quantile_sketch_add(&ranking->sketches[j], value), NULL, 0);
+                }
+                block[size++] = value;
+                if(size==STATISTICS_BLOCK || r==observation_number-1){
+                    merge_block(block, size, r+1-size, &ranking->stats[j], &squared_deviation);
+                    size = 0;
+                }
+                if(r==observation_number-1){
+                    stats = &ranking->stats[j];
+                    stats->variance = squared_deviation/observation_number;
+                    stats->standard_deviation = sqrt(stats->variance);
+                    stats->coeff_of_variation = f_coeff_of_variation(stats->mean, stats->standard_deviation);
+                }
+            }
+            position++;
+        }
+        if(code==AOIMO_OK && ferror(reader.file)){
+            code = set_error(error, AOIMO_EXISTENCE_ERROR, data_database, errno);
+        }
+        else if(code==AOIMO_OK && reader.offset+(long long)reader.end==0){
+            code = set_error(error, AOIMO_EMPTY_FILE_ERROR, data_database, 0);
+        }
+        else if(code==AOIMO_OK && position!=capacity){
+            if(error!=NULL){
+                error->observation_number = observation_number;
+                error->variables_number = variables_number;
+                error->data_number = position;
+            }
+            code = set_error(error, AOIMO_DATA_ERROR, data_database, 0);
+        }
+        else if(code==AOIMO_OK && first_error>=0){
+            if(error!=NULL){
+                error->position = first_error+1;
+            }
+            code = set_error(error, AOIMO_DATA_FORMAT_ERROR, data_database, 0);
+        }
+        fclose(reader.file);
+    }
+    free(reader.buffer);
+
+    for(j=0; j<variables_number && code==AOIMO_OK; j++){
+        code = set_error(error, quantile_sketch_query(&ranking->sketches[j], distribution_probabilities, DECILES+2, quantiles), NULL, 0);
+        store_distribution(quantiles, &ranking->stats[j]);
+    }
+    if(code!=AOIMO_OK){
+        stream_close(ranking);
+        return code;
+    }
+    *result = ranking;
+    return AOIMO_OK;
+}
+
+/**
+A structure that stores a run of a temporary file of a streamed ranking while runs are merged.
+*/
+typedef struct stream_cursor{
+    long long next; /**< position in the file of the first record of the run which is not in the buffer yet */
+    long long end; /**< position in the file after the last record of the run */
+    int size; /**< number of records in the buffer */
+    int position; /**< position of the current record in the buffer */
+} stream_cursor;
+
+/**
+A structure that stores the state of merging the runs of a streamed ranking.
+*/
+typedef struct stream_merge{
+    stream *ranking; /**< the streamed ranking */
+    stream_record *buffer; /**< STREAM_MERGE_BUFFER records of every merged run */
+    stream_cursor cursor[STREAM_FAN_IN]; /**< merged runs */
+    int heap[STREAM_FAN_IN]; /**< merged runs ordered by their current records, the best first */
+    int limit; /**< number of positions passed to the emit function by the last merge */
+    mapped_file observations; /**< the mapped observation file, names are read from it when they are passed to the emit function */
+    char *name; /**< the name passed to the emit function */
+    size_t name_capacity; /**< number of bytes allocated for the name */
+    void (*emit)(void *context, int position, double index, int id, const char *name); /**< the function getting positions of the ranking */
+    void *context; /**< a pointer passed to the emit function */
+} stream_merge;
+
+/**
+A function that takes 3 parameters and returns 1 if the next records of a run are read into its buffer, otherwise 0.
+*/
+static int cursor_read(stream_merge *merge, FILE *input, int c){
+    stream_cursor *cursor = &merge->cursor[c];
+    int n = cursor->end-cursor->next < STREAM_MERGE_BUFFER ? (int)(cursor->end-cursor->next) : STREAM_MERGE_BUFFER;
+
+    cursor->size = n;
+    cursor->position = 0;
+    if(fseeko(input, (off_t)cursor->next*sizeof(stream_record), SEEK_SET)!=0 || fread(merge->buffer+(size_t)c*STREAM_MERGE_BUFFER, sizeof(stream_record), n, input)!=(size_t)n){
+        return 0;
+    }
+    cursor->next += n;
+    return 1;
+}
+
+/**
+A function that takes 3 parameters and returns a pointer to the current record of a run.
+*/
+static stream_record *cursor_record(stream_merge *merge, int c){
+    return merge->buffer+(size_t)c*STREAM_MERGE_BUFFER+merge->cursor[c].position;
+}
+
+/**
+A function that takes 3 parameters and restores the order of the heap of merged runs below a given position.
+*/
+static void merge_sift(stream_merge *merge, int size, int position){
+    int child, temp;
+
+    while((child = 2*position+1)<size){
+        if(child+1<size && compare_entries(&cursor_record(merge, merge->heap[child+1])->entry, &cursor_record(merge, merge->heap[child])->entry)<0){
+            child++;
+        }
+        if(compare_entries(&cursor_record(merge, merge->heap[child])->entry, &cursor_record(merge, merge->heap[position])->entry)>=0){
+            break;
+        }
+        temp = merge->heap[position];
+        merge->heap[position] = merge->heap[child];
+        merge->heap[child] = temp;
+        position = child;
+    }
+}
+
+/**
+A function that takes 2 parameters and returns the name of the observation starting at a given offset of the mapped observation file (the name ends at a line break or at the end of the file), otherwise NULL if there is not enough memory.
+*/
+static const char *merge_name(stream_merge *merge, long long offset){
+    const char *line = merge->observations.data+offset, *end = merge->observations.data+merge->observations.size, *next;
+    size_t length;
+    int failed = 0;
+
+    next = line<end ? memchr(line, '\n', end-line) : NULL;
+    length = next!=NULL ? (size_t)(next-line) : line<end ? (size_t)(end-line) : 0;
+    if(length+1>merge->name_capacity){
+        merge->name = grow_array(merge->name, length+1, &failed);
+        if(failed){
+            return NULL;
+        }
+        merge->name_capacity = length+1;
+    }
+    memcpy(merge->name, line, length);
+    merge->name[length] = '\0';
+    return merge->name;
+}
+
+/**
+A function that takes 7 parameters and returns an error code of merging count runs of run_size records from the run first of the input file, the merged run is appended to the output file or, if it is NULL, passed to the emit function.
+*/
+static int merge_runs(stream_merge *merge, FILE *input, long long run_size, int first, int count, FILE *output, aoimo_error *error){
+    long long n = merge->ranking->observation_number;
+    double range = merge->ranking->ranking_maximum_result-merge->ranking->ranking_minimum_result;
+    stream_record *record;
+    const char *name;
+    int size = 0, position = 0, c;
+
+    for(c=0; c<count; c++){
+        merge->cursor[c].next = (first+c)*run_size;
+        merge->cursor[c].end = merge->cursor[c].next+run_size < n ? merge->cursor[c].next+run_size : n;
+        if(!cursor_read(merge, input, c)){
+            return set_error(error, AOIMO_EXISTENCE_ERROR, "temporary file", errno);
+        }
+        merge->heap[size++] = c;
+    }
+    for(c=size/2-1; c>=0; c--){
+        merge_sift(merge, size, c);
+    }
+    while(size>0 && (output!=NULL || position<merge->limit)){
+        c = merge->heap[0];
+        record = cursor_record(merge, c);
+        if(output!=NULL){
+            if(fwrite(record, sizeof(stream_record), 1, output)!=1){
+                return set_error(error, AOIMO_EXISTENCE_ERROR, "temporary file", errno);
+            }
+        }
+        else{
+            name = merge_name(merge, record->name);
+            if(name==NULL){
+                return set_error(error, AOIMO_MEMORY_ERROR, NULL, 0);
+            }
+            merge->emit(merge->context, position++, (record->entry.index-merge->ranking->ranking_minimum_result)/range, record->entry.id, name);
+        }
+        if(++merge->cursor[c].position==merge->cursor[c].size){
+            if(merge->cursor[c].next==merge->cursor[c].end){
+                merge->heap[0] = merge->heap[--size];
+            }
+            else if(!cursor_read(merge, input, c)){
+                return set_error(error, AOIMO_EXISTENCE_ERROR, "temporary file", errno);
+            }
+        }
+        merge_sift(merge, size, 0);
+    }
+    return set_error(error, AOIMO_OK, NULL, 0);
+}
+
+int stream_rank(stream *ranking, int top, void (*emit)(void *context, int position, double index, int id, const char *name), void *context, aoimo_error *error){
+    int n = ranking->observation_number, m = ranking->variables_number, blocks = ranking->blocks;
+    int b, i, j, first, count, kind, code = AOIMO_OK, runs_count;
+    long long run_size, offset;
+    double *scores = malloc(STREAM_BLOCK*sizeof(double));
+    ranking_entry *entries = malloc(STREAM_BLOCK*sizeof(ranking_entry));
+    long long *names = malloc(STREAM_BLOCK*sizeof(long long)), name = 0;
+    const char *token, *next;
+    size_t length;
+    double value;
+    statistics *stats;
+    stream_reader reader;
+    stream_record record;
+    stream_merge merge;
+    FILE *runs = NULL, *next_runs;
+
+    memset(&record, 0, sizeof(record));
+    memset(&merge.observations, 0, sizeof(merge.observations));
+    merge.name = NULL;
+    merge.name_capacity = 0;
+    merge.ranking = ranking;
+    merge.buffer = malloc((size_t)STREAM_FAN_IN*STREAM_MERGE_BUFFER*sizeof(stream_record));
+    merge.limit = top>0 && top<n ? top : n;
+    merge.emit = emit;
+    merge.context = context;
+    reader.buffer = malloc(STREAM_SEGMENT);
+    reader.size = STREAM_SEGMENT;
+    reader.file = NULL;
+    if(scores==NULL || entries==NULL || names==NULL || merge.buffer==NULL || reader.buffer==NULL){
+        code = set_error(error, AOIMO_MEMORY_ERROR, NULL, 0);
+    }
+    else if((reader.file = fopen(ranking->data_database, "rb"))==NULL){
+        code = set_error(error, AOIMO_EXISTENCE_ERROR, ranking->data_database, errno);
+    }
+    else{
+        code = map_file(ranking->observations_database, &merge.observations, error);
+    }
+    if(code==AOIMO_OK && (runs = tmpfile())==NULL){
+        code = set_error(error, AOIMO_EXISTENCE_ERROR, "temporary file", errno);
+    }
+
+    for(b=0; b<blocks && code==AOIMO_OK; b++){
+        first = b*STREAM_BLOCK;
+        count = n-first < STREAM_BLOCK ? n-first : STREAM_BLOCK;
+        for(i=0; i<count; i++){
+            scores[i] = 0;
+        }
+        for(j=0; j<m && code==AOIMO_OK; j++){
+            stats = &ranking->stats[j];
+            if(reader_seek(&reader, ranking->offsets[(size_t)j*blocks+b])!=0){
+                code = set_error(error, AOIMO_EXISTENCE_ERROR, ranking->data_database, errno);
+            }
+            for(i=0; i<count && code==AOIMO_OK; ){
+                kind = reader_next(&reader, &token, &length, &offset);
+                if(kind==0 || (kind==1 && !parse_value(token, token+length, &value))){
+                    code = set_error(error, AOIMO_DATA_FORMAT_ERROR, ranking->data_database, 0);
+                    if(error!=NULL){
+                        error->position = (long)j*n+first+i+1;
+                    }
+                }
+                else if(kind==1){
+                    scores[i++] += (value-stats->mean)/stats->standard_deviation;
+                }
+            }
+        }
+        if(code!=AOIMO_OK){
+            break;
+        }
+
+        for(i=0; i<count; i++){
+            scores[i] /= m;
+            entries[i].index = scores[i];
+            entries[i].id = first+i;
+        }
+        if(b==0){
+            ranking->ranking_minimum_result = scores[0];
+            ranking->ranking_maximum_result = scores[0];
+        }
+        for(i=0; i<count; i++){
+            if(scores[i]<ranking->ranking_minimum_result){
+                ranking->ranking_minimum_result = scores[i];
+            }
+            if(scores[i]>ranking->ranking_maximum_result){
+                ranking->ranking_maximum_result = scores[i];
+            }
+        }
+        for(i=0; i<count; i++){
+            names[i] = name;
+            next = name<(long long)merge.observations.size ? memchr(merge.observations.data+name, '\n', merge.observations.size-name) : NULL;
+            name = next!=NULL ? next-merge.observations.data+1 : (long long)merge.observations.size;
+        }
+        qsort(entries, count, sizeof(ranking_entry), compare_entries);
+        for(i=0; i<count; i++){
+            record.entry = entries[i];
+            record.name = names[entries[i].id-first];
+            fwrite(&record, sizeof(stream_record), 1, runs);
+        }
+        if(ferror(runs)){
+            code = set_error(error, AOIMO_EXISTENCE_ERROR, "temporary file", errno);
+        }
+    }
+
+    run_size = STREAM_BLOCK;
+    runs_count = blocks;
+    while(code==AOIMO_OK && runs_count>STREAM_FAN_IN){
+        next_runs = tmpfile();
+        if(next_runs==NULL){
+            code = set_error(error, AOIMO_EXISTENCE_ERROR, "temporary file", errno);
+            break;
+        }
+        for(b=0; b<runs_count && code==AOIMO_OK; b+=STREAM_FAN_IN){
+            code = merge_runs(&merge, runs, run_size, b, runs_count-b < STREAM_FAN_IN ? runs_count-b : STREAM_FAN_IN, next_runs, error);
+        }
+        fclose(runs);
+        runs = next_runs;
+        run_size *= STREAM_FAN_IN;
+        runs_count = (runs_count+STREAM_FAN_IN-1)/STREAM_FAN_IN;
+    }
+    if(code==AOIMO_OK){
+        code = merge_runs(&merge, runs, run_size, 0, runs_count, NULL, error);
+    }
+
+    if(runs!=NULL){
+        fclose(runs);
+    }
+    unmap_file(&merge.observations);
+    if(reader.file!=NULL){
+        fclose(reader.file);
+    }
+    free(reader.buffer);
+    free(merge.buffer);
+    free(merge.name);
+    free(names);
+    free(entries);
+    free(scores);
+    return code;
+}
+
+void stream_close(stream *ranking){
+    int j;
+
+    if(ranking==NULL){
+        return;
+    }
+    if(ranking->sketches!=NULL){
+        for(j=0; j<ranking->variables_number; j++){
+            quantile_sketch_free(&ranking->sketches[j]);
+        }
+    }
+    string_table_free(&ranking->variable);
+    free(ranking->stats);
+    free(ranking->sketches);
+    free(ranking->offsets);
+    free(ranking);
+}
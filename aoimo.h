@@ -0,0 +1,782 @@
+/**
+\file aoimo.h
+A header of the library, which computes rankings of incomparable multidimensional objects with the standardized sum, Hellwig, TOPSIS and rank methods (see \ref library and \ref methods).
+The library has no global state, every function works only on the structures passed to it, so different datasets can be processed at the same time by different threads.
+Functions which can fail return an error code (AOIMO_OK if there is no error) and, if a pointer to an aoimo_error structure is passed, the details of the error.
+*/
+
+#ifndef AOIMO_H
+#define AOIMO_H
+
+#include <stddef.h>
+
+/**
+A macro, which is the association of an identifier or parameterized identifier with a token string.
+*/
+#define MEMORY 102
+
+/**
+A macro, which is the number of deciles reported for every variable.
+*/
+#define DECILES 9
+
+/**
+A macro, which is the maximal number of levels of a quantile sketch, a sketch with the capacity c holds up to c*2^QUANTILE_SKETCH_LEVELS values.
+*/
+#define QUANTILE_SKETCH_LEVELS 48
+
+/**
+Error codes returned by the functions of the library.
+*/
+enum aoimo_error_code{
+    AOIMO_OK = 0, /**< no error */
+    AOIMO_EXISTENCE_ERROR, /**< a file does not exist or cannot be opened */
+    AOIMO_EMPTY_FILE_ERROR, /**< a file is empty */
+    AOIMO_DATA_ERROR, /**< number of data does not match number of observations and variables */
+    AOIMO_DATA_FORMAT_ERROR, /**< a value is not a number or there is an empty row */
+    AOIMO_MEMORY_ERROR, /**< memory could not be allocated */
+    AOIMO_CACHE_FORMAT_ERROR, /**< a binary cache file is incorrect */
+    AOIMO_OBSERVATION_ERROR, /**< an observation ID does not exist or the observation was deleted */
+    AOIMO_FIELD_ERROR, /**< a row of a table file has a different number of values than the header has variables */
+    AOIMO_GROUP_ERROR, /**< number of group keys does not match number of observations */
+    AOIMO_SETTINGS_ERROR /**< a line of a settings file is incorrect or the number of lines does not match number of variables */
+};
+
+/**
+Linear ordering methods computed by compute_method().
+*/
+enum aoimo_method{
+    AOIMO_SUM_METHOD = 0, /**< standardized sum method */
+    AOIMO_HELLWIG_METHOD, /**< Hellwig method (distance to the pattern of development) */
+    AOIMO_TOPSIS_METHOD, /**< TOPSIS method (relative distance to the ideal and anti-ideal solution) */
+    AOIMO_RANK_METHOD, /**< rank method (mean rank of an observation in all variables) */
+    AOIMO_METHODS /**< number of methods */
+};
+
+/**
+Directions of variables (see variable_setting).
+*/
+enum aoimo_direction{
+    AOIMO_STIMULANT = 0, /**< higher values are better */
+    AOIMO_DESTIMULANT, /**< lower values are better, the scaled values are negated */
+    AOIMO_NOMINANT /**< values closer to a target are better, a value x is converted to -|x-target| */
+};
+
+/**
+A structure that stores the direction and the weight of a variable.
+*/
+typedef struct variable_setting{
+    int direction; /**< direction from aoimo_direction */
+    double target; /**< target value of a nominant */
+    double weight; /**< positive weight of the variable, weights are normalized to the mean of 1 */
+} variable_setting;
+
+/**
+A structure that stores the details of an error reported by the library.
+*/
+typedef struct aoimo_error{
+    int code; /**< error code from aoimo_error_code */
+    int system_error; /**< value of errno for AOIMO_EXISTENCE_ERROR */
+    long position; /**< position of the incorrect value (from 1) for AOIMO_DATA_FORMAT_ERROR, line of the incorrect row (from 1) for AOIMO_FIELD_ERROR and AOIMO_SETTINGS_ERROR */
+    int observation_number; /**< number of observations for AOIMO_DATA_ERROR and AOIMO_GROUP_ERROR */
+    int variables_number; /**< number of variables for AOIMO_DATA_ERROR and AOIMO_FIELD_ERROR */
+    long data_number; /**< number of data for AOIMO_DATA_ERROR, number of values of the incorrect row for AOIMO_FIELD_ERROR, number of group keys for AOIMO_GROUP_ERROR */
+    const char *file_name; /**< name of the file which caused the error, NULL if the error is not related to a file */
+} aoimo_error;
+
+/**
+A structure that stores a file mapped into memory.
+*/
+typedef struct mapped_file{
+    char *data; /**< contents of the file */
+    size_t size; /**< size of the file in bytes */
+} mapped_file;
+
+/**
+A structure that stores names in a single contiguous arena, a name is identified by its number in the table (see string_table_add()).
+A structure filled with zeros is an empty table.
+*/
+typedef struct string_table{
+    char *arena; /**< names one after another, every name is ended with a zero byte */
+    size_t *offset; /**< offset of every name in the arena */
+    int *length; /**< length of every name without the zero byte */
+    int count; /**< number of names */
+    int capacity; /**< number of names which fit in the allocated memory */
+    size_t size; /**< number of used bytes of the arena */
+    size_t arena_capacity; /**< number of bytes of the arena */
+} string_table;
+
+/**
+A structure that owns a heap-allocated dataset stored column-major (variable by variable).
+*/
+typedef struct dataset{
+    int observation_number; /**< number of observations (rows) */
+    int variables_number; /**< number of variables (columns) */
+    string_table observation; /**< names of observations */
+    string_table variable; /**< names of variables */
+    double *values; /**< values of the dataset, variable i starts at values[i*observation_number] */
+    mapped_file mapping; /**< binary cache file holding the values, empty if the values are allocated on the heap */
+    size_t values_capacity; /**< number of values which fit in the allocated memory */
+} dataset;
+
+/**
+A structure that stores descriptive statistics of a variable.
+*/
+typedef struct statistics{
+    double minimum; /**< minimal value */
+    double maximum; /**< maximal value */
+    double mean; /**< mean value */
+    double median; /**< median value */
+    double quartile_1; /**< first quartile value */
+    double quartile_3; /**< third quartile value */
+    double interquartile_range; /**< difference between the third and the first quartile */
+    double decile[DECILES]; /**< deciles from the first to the ninth */
+    double standard_deviation; /**< standard deviation value */
+    double variance; /**< variance value */
+    double coeff_of_variation; /**< coefficient of variation value (%) */
+    double ideal; /**< best scaled value (the pattern of the Hellwig method and the ideal solution of TOPSIS), set by compute_ranking() */
+    double anti_ideal; /**< worst scaled value (the anti-ideal solution of TOPSIS), set by compute_ranking() */
+} statistics;
+
+/**
+A structure that stores a position of the ranking.
+*/
+typedef struct ranking_entry{
+    double index; /**< index value of the observation */
+    int id; /**< observation ID */
+} ranking_entry;
+
+/**
+A structure that stores the buffers of the computation of a ranking shared by the tasks of compute_ranking().
+*/
+typedef struct computation{
+    dataset *data; /**< dataset, scaled in place */
+    const variable_setting *settings; /**< direction and weight of every variable, NULL if all variables are stimulants with equal weights */
+    statistics *stats; /**< statistics of variables (of the values from the dataset, also for destimulants and nominants) */
+    double *data_copy; /**< a buffer of observation_number values for every thread */
+    double *ranking_mean_result; /**< mean values of observations */
+    double *ranking_index_result; /**< index values of observations */
+    double ranking_minimum_result; /**< result of ranking_f_minimum() */
+    double ranking_maximum_result; /**< result of ranking_f_maximum() */
+    ranking_entry *order; /**< positions of the ranking */
+    ranking_entry *sort_copy; /**< a buffer of observation_number pairs of a value and an observation ID for every thread, used only by the rank method */
+    double weight_factor; /**< number of variables divided by the sum of weights, set by compute_ranking() */
+    int method; /**< linear ordering method of the index values and the ranking, from aoimo_method */
+    int top; /**< number of the best positions of the ranking to find, 0 for all */
+    int positions; /**< number of positions of the ranking */
+    int observation_capacity; /**< number of observations which fit in the buffers */
+    int variables_capacity; /**< number of variables which fit in the buffers */
+    int threads_capacity; /**< number of threads which fit in data_copy */
+} computation;
+
+/**
+A structure that stores a partition of observations into groups and the rankings of the standardized sum method within every group (see compute_groups()).
+Observations of a group are kept together in member, in the order of their IDs, so the group g occupies the positions from first[g] to first[g+1]-1 of member and of the buffers of results.
+*/
+typedef struct grouping{
+    int group_number; /**< number of groups */
+    int observation_number; /**< number of observations */
+    int variables_number; /**< number of variables of the last computation */
+    string_table name; /**< names of groups in the order of their first observation */
+    int *group; /**< group of every observation */
+    int *first; /**< first position of every group in member, first[group_number] is observation_number */
+    int *member; /**< observation IDs sorted by group */
+    double *mean_result; /**< mean of the variable j in the group g at mean_result[g*variables_number+j] */
+    double *sd_result; /**< standard deviation of the variable j in the group g at sd_result[g*variables_number+j] */
+    double *ranking_mean_result; /**< mean scaled value of the observation at every position of member */
+    double *ranking_index_result; /**< index value of the observation at every position of member */
+    ranking_entry *order; /**< positions of the ranking of every group, starting at first[g], with observation IDs */
+    int *positions; /**< number of positions of the ranking of every group */
+    int *count; /**< a buffer of group_number counters for every thread */
+    int top; /**< number of the best positions of every ranking to find, 0 for all */
+    int variables_capacity; /**< number of variables which fit in mean_result and sd_result */
+    int threads_capacity; /**< number of threads which fit in count */
+} grouping;
+
+/**
+A structure that stores the settings of a resampling of a dataset (see ranking_resample()).
+*/
+typedef struct resampling{
+    int replicates; /**< number of bootstrap replicates, for the jackknife it has to be equal to observation_number */
+    int jackknife; /**< 1 for the jackknife (the replicate k leaves out the observation k), 0 for the bootstrap (observations drawn with replacement) */
+    int variables; /**< 1 if variables are also drawn with replacement in every bootstrap replicate, otherwise 0 */
+    unsigned long long seed; /**< seed of random numbers, every replicate has its own stream derived from the seed and its number */
+} resampling;
+
+/**
+A structure that stores a ranking, which is kept up to date while observations are inserted, updated and deleted (see incremental_refresh()).
+Observations are stored by rows, so a change touches a single block of values. IDs of observations are given in the order of insertion and are not reused after a deletion.
+*/
+typedef struct incremental{
+    int observation_number; /**< number of observations */
+    int variables_number; /**< number of variables */
+    int id_number; /**< number of IDs given to observations, including deleted ones */
+    int row_capacity; /**< number of rows which fit in the allocated memory */
+    int id_capacity; /**< number of IDs which fit in the allocated memory */
+    double *values; /**< values of observations, the row r starts at values[r*variables_number] */
+    int *id; /**< observation ID of every row */
+    int *row; /**< row of every observation ID, -1 for deleted observations */
+    string_table observation; /**< names of observations by ID */
+    string_table variable; /**< names of variables */
+    double *shift; /**< value of every variable subtracted before it is added to the sums (the mean when the sums were computed exactly) */
+    double *sum; /**< running sum of shifted values of every variable */
+    double *sum_of_squares; /**< running sum of squared shifted values of every variable */
+    double *weight; /**< inverse of the standard deviation of every variable used by the current scores */
+    double *weight_change; /**< difference between the new and the previous weight of every variable, used by a refresh */
+    int *changed_column; /**< variables whose weights changed since the previous refresh */
+    double *score; /**< score of every row, the sum of shifted values multiplied by weights */
+    char *changed_row; /**< 1 if the row has to be scored again */
+    double *sorted; /**< values of every variable in ascending order (values which are not a number at the end), the variable j starts at sorted[j*row_capacity] */
+    int sorted_changes; /**< number of changes since the last refresh, the sorted values are sorted again by the next refresh if it exceeds SORTED_CHANGES */
+    statistics *stats; /**< statistics of variables */
+    ranking_entry *order; /**< positions of the ranking, the index field holds the score (see incremental_index()) */
+    int positions; /**< number of positions of the ranking */
+    int ranked_ids; /**< id_number at the last refresh, observations with greater IDs are not in the order yet */
+    int changes; /**< number of changes since the sums were computed exactly */
+    double minimum_score; /**< minimal score which is a number */
+    double maximum_score; /**< maximal score which is a number */
+} incremental;
+
+/**
+A structure that stores a mergeable sketch of the distribution of values, which approximates quantiles in memory that grows only with the logarithm of the number of values (see quantile_sketch_add()).
+A value kept at the level l stands for 2^l added values. A full level is sorted and every second value (alternately from the first and the second one) is moved to the next level, so the rank of a value is known up to an error of about levels/capacity of the number of values, quantiles are exact as long as no level has been compacted.
+*/
+typedef struct quantile_sketch{
+    double *level[QUANTILE_SKETCH_LEVELS]; /**< values kept at every level, NULL for levels which have not been used */
+    int size[QUANTILE_SKETCH_LEVELS]; /**< number of values kept at every level */
+    int levels; /**< number of used levels */
+    int capacity; /**< number of values of a level, an even number */
+    int parity; /**< 0 or 1, the position of the first value moved by the next compaction */
+    long long count; /**< number of added values which are numbers */
+} quantile_sketch;
+
+/**
+A structure that stores a ranking of the standardized sum method computed from the files without keeping the dataset in memory (see stream_open() and stream_rank()).
+The memory does not depend on the number of observations, apart from a single offset for every block of observations of every variable.
+*/
+typedef struct stream{
+    int observation_number; /**< number of observations */
+    int variables_number; /**< number of variables */
+    string_table variable; /**< names of variables */
+    statistics *stats; /**< statistics of variables, the median, quartiles and deciles are approximated by sketches */
+    quantile_sketch *sketches; /**< sketch of the distribution of every variable */
+    long long *offsets; /**< offset in the data file of the first value of every block of observations of every variable, the block b of the variable j at offsets[j*blocks+b] */
+    int blocks; /**< number of blocks of observations */
+    const char *observations_database; /**< name of the observation file */
+    const char *data_database; /**< name of the data file */
+    double ranking_minimum_result; /**< minimal mean value of observations, known after stream_rank() */
+    double ranking_maximum_result; /**< maximal mean value of observations, known after stream_rank() */
+} stream;
+
+/**
+A structure that stores a pool of threads (its fields are private to the library).
+*/
+typedef struct thread_pool thread_pool;
+
+/**
+A function that takes 3 parameters and returns an error code of adding a name at the end of a table of names.
+\param *table - a pointer to a table of names
+\param *name - a pointer to the characters of the name, it does not have to be ended with a zero byte
+\param length - a number of characters of the name
+*/
+int string_table_add(string_table *table, const char *name, size_t length);
+
+/**
+A function that takes 4 parameters and returns an error code of adding the lines of a text (e.g. a mapped file) as names at the end of a table of names, the whole text is copied into the arena at once and line breaks are replaced with zero bytes.
+\param *table - a pointer to a table of names
+\param *text - a pointer to the text
+\param size - a number of characters of the text
+\param count - an integer number of names to be added, lines after the last one are skipped and missing lines give empty names
+*/
+int string_table_split(string_table *table, const char *text, size_t size, int count);
+
+/**
+A function that takes 2 parameters and returns a pointer to a name ended with a zero byte.
+\param *table - a pointer to a table of names
+\param id - an integer number of the name from 0
+*/
+const char *string_table_get(const string_table *table, int id);
+
+/**
+A function that takes a parameter and removes all names from a table of names, the memory is kept for new names.
+\param *table - a pointer to a table of names
+*/
+void string_table_clear(string_table *table);
+
+/**
+A function that takes a parameter and releases the memory of a table of names, the table is empty after the call.
+\param *table - a pointer to a table of names
+*/
+void string_table_free(string_table *table);
+
+/**
+A function that takes 2 parameters and returns a pointer to a new dataset allocated on the heap or NULL if there is not enough memory, the dataset has to be released with dataset_free().
+\param observation_number - an integer number of observations
+\param variables_number - an integer number of variables
+*/
+dataset *dataset_create(int observation_number, int variables_number);
+
+/**
+A function that takes 3 parameters and changes the number of observations and variables of a dataset, memory is allocated again only if the values do not fit in it, the values have to be filled again and the tables of names are emptied.
+\param *data - a pointer to a dataset
+\param observation_number - an integer number of observations
+\param variables_number - an integer number of variables
+*/
+int dataset_resize(dataset *data, int observation_number, int variables_number);
+
+/**
+A function that takes 5 parameters and returns a pointer to a new dataset with copies of values and names given in memory or NULL if there is not enough memory, the dataset has to be released with dataset_free().
+\param observation_number - an integer number of observations
+\param variables_number - an integer number of variables
+\param values[observation_number*variables_number] - a double array of values, variable by variable (column-major)
+\param observation[observation_number] - an array of names of observations, NULL for empty names
+\param variable[variables_number] - an array of names of variables, NULL for empty names
+*/
+dataset *dataset_from_arrays(int observation_number, int variables_number, const double values[], const char *const observation[], const char *const variable[]);
+
+/**
+A function that takes a parameter and releases a dataset created by dataset_create().
+\param *data - a pointer to a dataset
+*/
+void dataset_free(dataset *data);
+
+/**
+A function that takes 2 parameters and returns a pointer to the contiguous values of a given variable.
+\param *data - a pointer to a dataset
+\param i - an integer variable ID
+*/
+double *dataset_column(dataset *data, int i);
+
+/**
+A function that takes 5 parameters and returns an error code of reading a dataset from the observation, variable and data files.
+\param *data - a pointer to a dataset, it is resized to the files
+\param *observations_database - a pointer to the name of the observation file
+\param *variables_database - a pointer to the name of the variable file
+\param *data_database - a pointer to the name of the data file
+\param *error - a pointer to the details of an error to be filled or NULL
+*/
+int load_dataset(dataset *data, const char *observations_database, const char *variables_database, const char *data_database, aoimo_error *error);
+
+/**
+A function that takes 3 parameters and returns an error code of writing a dataset into a binary cache file.
+\param *data - a pointer to a dataset
+\param *file_name - a pointer to the name of the binary cache file
+\param *error - a pointer to the details of an error to be filled or NULL
+*/
+int dataset_save_cache(dataset *data, const char *file_name, aoimo_error *error);
+
+/**
+A function that takes 3 parameters and returns an error code of reading a dataset with values mapped from a binary cache file, the dataset has to be released with dataset_free().
+\param **data - a pointer to a pointer to a new dataset to be filled
+\param *file_name - a pointer to the name of the binary cache file
+\param *error - a pointer to the details of an error to be filled or NULL
+*/
+int dataset_load_cache(dataset **data, const char *file_name, aoimo_error *error);
+
+/**
+A function that takes 3 parameters and returns an error code of mapping a chosen file into memory.
+\param *file_name - a pointer to the name of the file
+\param *mapped - a pointer to the mapped file to be filled, the mapping is private so the contents can be modified without changing the file
+\param *error - a pointer to the details of an error to be filled or NULL
+*/
+int map_file(const char *file_name, mapped_file *mapped, aoimo_error *error);
+
+/**
+A function that takes 3 parameters and returns an error code of computing a 64-bit hash of the contents of a file, files with equal contents have equal hashes on the same machine.
+The file is mapped and read 8 bytes at a time, which is much faster than parsing it, so the hash can be used as the key of a cache of parsed datasets.
+\param *file_name - a pointer to the name of the file
+\param *hash - a pointer to the hash to be filled
+\param *error - a pointer to the details of an error to be filled or NULL
+*/
+int file_hash(const char *file_name, unsigned long long *hash, aoimo_error *error);
+
+/**
+A function that takes a parameter and releases a file mapped by map_file().
+\param *mapped - a pointer to the mapped file
+*/
+void unmap_file(mapped_file *mapped);
+
+/**
+A function that takes 3 parameters and returns an error code of reading the values of a mapped data file into a dataset in a single pass.
+\param *mapped - a pointer to the mapped data file
+\param *data - a pointer to a dataset
+\param *error - a pointer to the details of an error to be filled or NULL
+*/
+int load_data(mapped_file *mapped, dataset *data, aoimo_error *error);
+
+/**
+A function that takes 4 parameters and returns an error code of reading a dataset from a single CSV or TSV table file: a header row with a name of the observation column and the names of variables, followed by a row for every observation with its name and values.
+The separator is a tab if the header contains one, otherwise a comma, fields may be quoted (with "" for a quote inside) but may not contain line breaks, empty rows are skipped.
+The file is split into chunks which end at line breaks and the chunks are parsed by the pool of threads straight into the columns of the dataset.
+\param *data - a pointer to a dataset, it is resized to the file
+\param *file_name - a pointer to the name of the table file
+\param *pool - a pointer to a pool of threads or NULL to parse the file in the calling thread
+\param *error - a pointer to the details of an error to be filled or NULL
+*/
+int load_table(dataset *data, const char *file_name, thread_pool *pool, aoimo_error *error);
+
+/**
+A function that takes a parameter and returns a pointer to a new pool of threads or NULL if the threads could not be created, the pool has to be released with thread_pool_free().
+\param threads - an integer number of threads including the calling thread
+*/
+thread_pool *thread_pool_create(int threads);
+
+/**
+A function that takes a parameter and returns the number of threads of a pool including the calling thread.
+\param *pool - a pointer to a pool of threads, NULL for the calling thread only
+*/
+int thread_pool_threads(thread_pool *pool);
+
+/**
+A function that takes 4 parameters and runs tasks from 0 to count-1 on all threads of the pool, it returns when all tasks are completed.
+\param *pool - a pointer to a pool of threads, NULL to run all tasks on the calling thread
+\param task - a function running a task, it gets the context, the task number and the thread number (from 0 to threads-1)
+\param *context - a pointer passed to the task function
+\param count - an integer number of tasks
+*/
+void thread_pool_run(thread_pool *pool, void (*task)(void *context, int i, int thread), void *context, int count);
+
+/**
+A function that takes a parameter and stops and releases a pool of threads created by thread_pool_create().
+\param *pool - a pointer to a pool of threads
+*/
+void thread_pool_free(thread_pool *pool);
+
+/**
+A function that takes 4 parameters and returns an error code of preparing the buffers of a computation for a dataset, memory is allocated again only if the dataset does not fit in the buffers.
+\param *work - a pointer to the buffers of the computation, all pointers have to be NULL and capacities 0 before the first call
+\param *data - a pointer to a dataset
+\param threads - an integer number of threads of the computation
+\param top - an integer number of the best positions of the ranking, 0 for all
+*/
+int computation_reserve(computation *work, dataset *data, int threads, int top);
+
+/**
+A function that takes 4 parameters and returns an error code of reading the direction and the weight of every variable from a settings file, one line per variable in the order of the variable file: stimulant [WEIGHT], destimulant [WEIGHT] or nominant TARGET [WEIGHT], the weight is 1 if it is not given and it has to be positive.
+\param settings[variables_number] - an array of settings of variables to be filled
+\param *file_name - a pointer to the name of the settings file
+\param variables_number - an integer number of variables
+\param *error - a pointer to the details of an error to be filled or NULL
+*/
+int variable_settings_load(variable_setting settings[], const char *file_name, int variables_number, aoimo_error *error);
+
+/**
+A function that takes a parameter and releases the buffers of a computation.
+\param *work - a pointer to the buffers of the computation
+*/
+void computation_free(computation *work);
+
+/**
+A function that takes 2 parameters and computes statistics of all variables, scales the dataset and computes mean and index values and the ranking of all observations with the standardized sum method.
+If settings are given, destimulants and nominants are converted to stimulants and scaled values are multiplied by the normalized weights in the same pass which scales a variable, so the dataset is neither copied nor read again (a nominant needs a single extra read of its column for the statistics of the converted values). The rank method uses the directions but not the weights.
+The buffers can be prepared by computation_reserve() or provided by the caller: stats (variables_number statistics), data_copy (observation_number values for every thread of the pool), ranking_mean_result, ranking_index_result and order (observation_number elements, or top positions if top is not 0), and sort_copy (observation_number pairs for every thread) if the rank method is used later. Nothing is allocated, so the function cannot fail.
+\param *work - a pointer to the buffers of the computation
+\param *pool - a pointer to a pool of threads, NULL to compute on the calling thread only
+*/
+void compute_ranking(computation *work, thread_pool *pool);
+
+/**
+A function that takes 2 parameters and scales the dataset like compute_ranking() (with the settings, if they are given) when the statistics of all variables are already computed, so the phases of the ranking can be timed separately.
+\param *work - a pointer to the buffers of a computation with the statistics of all variables
+\param *pool - a pointer to a pool of threads, NULL to compute on the calling thread only
+*/
+void compute_scaling(computation *work, thread_pool *pool);
+
+/**
+A function that takes 3 parameters and computes the index values of all observations with a given method from the dataset scaled by compute_ranking(), like compute_method() but without ordering them.
+\param *work - a pointer to the buffers of a computation after compute_ranking()
+\param *pool - a pointer to a pool of threads, NULL to compute on the calling thread only
+\param method - an integer method from aoimo_method
+*/
+void compute_scores(computation *work, thread_pool *pool, int method);
+
+/**
+A function that takes 3 parameters and computes the index values and the ranking of all observations with a given method from the dataset scaled by compute_ranking(), so one scaled dataset can be ranked with several methods.
+The standardized sum method stores the mean values in ranking_mean_result, the Hellwig method the distances to the pattern and the TOPSIS method the distances to the ideal solution, the rank method the mean ranks.
+\param *work - a pointer to the buffers of a computation after compute_ranking()
+\param *pool - a pointer to a pool of threads, NULL to compute on the calling thread only
+\param method - an integer method from aoimo_method
+*/
+void compute_method(computation *work, thread_pool *pool, int method);
+
+/**
+A function that takes 3 parameters and computes minimum, maximum, mean, standard deviation, variance and coefficient of variation of a given variable in a single pass.
+\param *data - a pointer to a dataset
+\param i - an integer variable ID
+\param *result - a pointer to the statistics of the variable to be filled (quantiles are computed by f_distribution())
+*/
+void f_statistics(dataset *data, int i, statistics *result);
+
+/**
+A function that takes 6 parameters and returns an error code of computing quantiles of a given variable of arbitrary orders with a single selection over a copy of the variable.
+\param *data - a pointer to a dataset
+\param data_copy[observation_number] - a double buffer for a partially ordered copy of the variable
+\param i - an integer variable ID
+\param probabilities[count] - a double array of orders of quantiles from the range [0,1]
+\param count - an integer number of quantiles
+\param quantiles[count] - a double array of quantiles to be filled
+*/
+int f_quantiles(dataset *data, double data_copy[], int i, const double probabilities[], int count, double quantiles[]);
+
+/**
+A function that takes 4 parameters and computes the median, quartiles, interquartile range and deciles of a given variable.
+\param *data - a pointer to a dataset
+\param data_copy[observation_number] - a double buffer for a partially ordered copy of the variable
+\param i - an integer variable ID
+\param *result - a pointer to the statistics of the variable to be filled
+*/
+void f_distribution(dataset *data, double data_copy[], int i, statistics *result);
+
+/**
+A function that takes 2 parameters and returns the coefficient of variation value of a given variable.
+\param mean - a mean value of the variable
+\param standard_deviation - a standard deviation value of the variable
+*/
+double f_coeff_of_variation(double mean, double standard_deviation);
+
+/**
+A function that takes 4 parameters and returns the scaled value of the dataset.
+\param *data - a pointer to a dataset
+\param stats[variables_number] - an array of statistics of variables
+\param i - an integer column ID in dataset
+\param j - an integer row ID in dataset
+*/
+double f_scale(dataset *data, statistics stats[], int i, int j);
+
+/**
+A function that takes 4 parameters and computes the mean values of given observations.
+\param *data - a pointer to a dataset
+\param first - an integer ID of the first observation
+\param last - an integer ID of the observation after the last one
+\param ranking_mean_result[observation_number] - a double array of mean values to be filled
+*/
+void ranking_f_mean(dataset *data, int first, int last, double ranking_mean_result[]);
+
+/**
+A function that takes 2 parameters and returns the minimum value of mean values in observations array.
+\param ranking_mean_result[observation_number] - a double array of mean values
+\param n - an integer number of observations
+*/
+double ranking_f_minimum(double ranking_mean_result[], int n);
+
+/**
+A function that takes 2 parameters and returns the maximum value of mean values in observations array.
+\param ranking_mean_result[observation_number] - a double array of mean values
+\param n - an integer number of observations
+*/
+double ranking_f_maximum(double ranking_mean_result[], int n);
+
+/**
+A function that takes 4 parameters and returns the index value of an observation.
+\param ranking_mean_result[observation_number] - a double array of mean values
+\param ranking_minimum_result - a result of ranking_f_minimum()
+\param ranking_maximum_result - a result of ranking_f_maximum()
+\param i - an integer observation ID
+*/
+double ranking_f_index(double ranking_mean_result[], double ranking_minimum_result, double ranking_maximum_result, int i);
+
+/**
+A function that takes 4 parameters and returns the number of positions of the ranking, sorted from the best to the worst observation.
+\param ranking_index_result[observation_number] - a double array of index values
+\param n - an integer number of observations
+\param top - an integer number of the best positions to find, 0 for all
+\param order[n] - an array of positions of the ranking to be filled, only the first top positions are used if top is not 0
+*/
+int ranking_order(double ranking_index_result[], int n, int top, ranking_entry order[]);
+
+/**
+A function that takes 4 parameters and computes how the position of every observation in the ranking of the standardized sum method changes when a single variable is left out.
+Scaling of a variable does not depend on other variables, so the score without the variable j is the sum of scaled values of an observation minus its scaled value of the variable j, and all scores are derived from the sums in O(observation_number*variables_number). Every variable is then ranked with a single sort by the thread pool (in sort_copy), nothing is allocated, so the function cannot fail.
+\param *work - a pointer to the buffers of a computation after compute_ranking(), the standardized sum method is computed again if another method was computed later
+\param *pool - a pointer to a pool of threads, NULL to compute on the calling thread only
+\param positions[observation_number] - an integer array of positions (from 1) of observations in the ranking with all variables to be filled
+\param shifts[observation_number*variables_number] - an integer array to be filled, shifts[i*variables_number+j] is the position of the observation i without the variable j minus its position with all variables (positive if the observation moves down)
+*/
+void ranking_sensitivity(computation *work, thread_pool *pool, int positions[], int shifts[]);
+
+/**
+A function that takes 4 parameters and returns an error code of partitioning observations into groups by their keys, observations with equal keys are in the same group.
+\param *groups - a pointer to a grouping filled with zeros or released by grouping_free()
+\param *keys - a pointer to a table of the key of every observation
+\param observation_number - an integer number of observations, it has to be equal to the number of keys
+\param top - an integer number of the best positions of every ranking to find, 0 for all
+*/
+int grouping_create(grouping *groups, const string_table *keys, int observation_number, int top);
+
+/**
+A function that takes 5 parameters and returns an error code of reading the keys of groups (one per line, in the order of observations) from a file and partitioning observations into groups (see grouping_create()).
+\param *groups - a pointer to a grouping filled with zeros or released by grouping_free()
+\param *file_name - a pointer to the name of the group file
+\param observation_number - an integer number of observations
+\param top - an integer number of the best positions of every ranking to find, 0 for all
+\param *error - a pointer to the details of an error to be filled or NULL
+*/
+int grouping_load(grouping *groups, const char *file_name, int observation_number, int top, aoimo_error *error);
+
+/**
+A function that takes 4 parameters and returns an error code of computing the ranking of the standardized sum method within every group: the mean and standard deviation of every variable in every group are found in a single scan of every column (variables in parallel), then observations are scaled with the statistics of their group and ranked, with index values normalized by the minimum and maximum of the group (groups in parallel).
+The dataset is not changed, so it has to be called before compute_ranking(), which scales the dataset in place.
+\param *groups - a pointer to a grouping of the observations of the dataset
+\param *data - a pointer to a dataset
+\param settings[variables_number] - an array of directions and weights of variables applied while values are read (see compute_ranking()), NULL if all variables are stimulants with equal weights
+\param *pool - a pointer to a pool of threads, NULL to compute on the calling thread only
+*/
+int compute_groups(grouping *groups, dataset *data, const variable_setting settings[], thread_pool *pool);
+
+/**
+A function that takes a parameter and releases the memory of a grouping, the grouping is filled with zeros after the call.
+\param *groups - a pointer to a grouping
+*/
+void grouping_free(grouping *groups);
+
+/**
+A function that takes a parameter and returns the next random number of a splitmix64 generator, the same state always gives the same sequence on every machine.
+\param *state - a pointer to the state of the generator, any value can be used as a seed
+*/
+unsigned long long next_random(unsigned long long *state);
+
+/**
+A function that takes 4 parameters and returns an error code of computing the positions of all observations in rankings of resampled datasets.
+In every replicate the means and standard deviations of variables are computed from the resampled observations (an observation drawn k times counts k times), all observations of the dataset are scaled with them and ranked by the standardized sum method. Replicates are computed in parallel, every thread has its own buffers allocated once, and the positions do not depend on the number of threads.
+\param *data - a pointer to a dataset, which is not modified
+\param *pool - a pointer to a pool of threads, NULL to compute on the calling thread only
+\param *settings - a pointer to the settings of the resampling
+\param positions[observation_number*replicates] - an integer array of positions (from 1) to be filled, the position of the observation i in the replicate b is positions[i*replicates+b]
+*/
+int ranking_resample(dataset *data, thread_pool *pool, const resampling *settings, int positions[]);
+
+/**
+A function that takes 6 parameters and returns an error code of computing percentiles of the positions of every observation in the replicates of ranking_resample().
+\param positions[observation_number*replicates] - an integer array of positions filled by ranking_resample()
+\param observation_number - an integer number of observations
+\param replicates - an integer number of replicates
+\param probabilities[count] - a double array of orders of percentiles from the range [0,1]
+\param count - an integer number of percentiles
+\param percentiles[observation_number*count] - a double array of percentiles to be filled, percentiles of the observation i start at percentiles[i*count]
+*/
+int resampling_percentiles(const int positions[], int observation_number, int replicates, const double probabilities[], int count, double percentiles[]);
+
+/**
+A function that takes 2 parameters and returns an error code of creating an incremental ranking of the observations of a dataset, the ranking is ready after incremental_refresh().
+\param **engine - a pointer to the new incremental ranking, which has to be released with incremental_free(), NULL on error
+\param *data - a pointer to a dataset, which is copied and not scaled
+*/
+int incremental_create(incremental **engine, dataset *data);
+
+/**
+A function that takes a parameter and releases an incremental ranking.
+\param *engine - a pointer to an incremental ranking
+*/
+void incremental_free(incremental *engine);
+
+/**
+A function that takes 2 parameters and returns the ID of the observation with a given name, -1 if there is no such observation.
+\param *engine - a pointer to an incremental ranking
+\param *name - a pointer to the name of the observation
+*/
+int incremental_find(incremental *engine, const char *name);
+
+/**
+A function that takes 3 parameters and returns an error code of adding an observation, its ID is id_number-1 after the call.
+\param *engine - a pointer to an incremental ranking
+\param *name - a pointer to the name of the observation
+\param values[variables_number] - a double array of values of the observation
+*/
+int incremental_insert(incremental *engine, const char *name, const double values[]);
+
+/**
+A function that takes 3 parameters and returns an error code of changing the values of an observation.
+\param *engine - a pointer to an incremental ranking
+\param id - an integer observation ID
+\param values[variables_number] - a double array of new values of the observation
+*/
+int incremental_update(incremental *engine, int id, const double values[]);
+
+/**
+A function that takes 2 parameters and returns an error code of deleting an observation.
+\param *engine - a pointer to an incremental ranking
+\param id - an integer observation ID
+*/
+int incremental_delete(incremental *engine, int id);
+
+/**
+A function that takes 2 parameters and brings the statistics of variables and the ranking up to date after changes.
+The mean, standard deviation and variance come from the running sums, the minimum, maximum and quantiles from the sorted values. Changed rows are scored again, the scores of other rows are only corrected for the variables whose standard deviations changed (one multiply-add per row and changed variable), and the previous order is repaired by insertion sort instead of being sorted again.
+An update which changes k values costs O(n*k) besides the repair of the order, but an insertion or a deletion changes the standard deviations of all variables, so it costs O(n*m) like the scoring of a complete computation, only the statistics, quantiles and the sorting are saved.
+\param *engine - a pointer to an incremental ranking
+\param *pool - a pointer to a pool of threads, NULL to compute on the calling thread only
+*/
+void incremental_refresh(incremental *engine, thread_pool *pool);
+
+/**
+A function that takes 2 parameters and returns the index value of a position of the ranking after incremental_refresh().
+\param *engine - a pointer to an incremental ranking
+\param position - an integer position of the ranking from 0
+*/
+double incremental_index(incremental *engine, int position);
+
+/**
+A function that takes 2 parameters and prepares an empty quantile sketch, memory is allocated when values are added.
+\param *sketch - a pointer to the sketch to be filled, it has to be released with quantile_sketch_free()
+\param capacity - an even integer number of values of a level, at least 2, the error of quantiles is smaller for a larger capacity
+*/
+void quantile_sketch_init(quantile_sketch *sketch, int capacity);
+
+/**
+A function that takes 2 parameters and returns an error code of adding a value to a quantile sketch, values which are not a number are skipped.
+\param *sketch - a pointer to a quantile sketch
+\param value - a double value
+*/
+int quantile_sketch_add(quantile_sketch *sketch, double value);
+
+/**
+A function that takes 2 parameters and returns an error code of adding all values of a quantile sketch to another one, e.g. sketches of parts of a variable computed separately.
+\param *sketch - a pointer to a quantile sketch
+\param *other - a pointer to a quantile sketch with the same capacity, which is not modified
+*/
+int quantile_sketch_merge(quantile_sketch *sketch, const quantile_sketch *other);
+
+/**
+A function that takes 4 parameters and returns an error code of approximating quantiles of the values added to a quantile sketch, interpolated linearly like the quantiles of f_quantiles().
+\param *sketch - a pointer to a quantile sketch with at least one value
+\param probabilities[count] - a double array of orders of quantiles from the range [0,1]
+\param count - an integer number of quantiles
+\param quantiles[count] - a double array of quantiles to be filled
+*/
+int quantile_sketch_query(const quantile_sketch *sketch, const double probabilities[], int count, double quantiles[]);
+
+/**
+A function that takes a parameter and releases the memory of a quantile sketch.
+\param *sketch - a pointer to a quantile sketch
+*/
+void quantile_sketch_free(quantile_sketch *sketch);
+
+/**
+A function that takes 5 parameters and returns an error code of the first pass of a streamed ranking, which reads the data file once in chunks of a fixed size and computes the statistics of variables.
+The mean, standard deviation, variance, minimum and maximum are computed from blocks of values exactly like by f_statistics(), the median, quartiles and deciles are approximated by a quantile sketch of every variable.
+\param **result - a pointer to the new streamed ranking, which has to be released with stream_close(), NULL on error
+\param *observations_database - a pointer to the name of the observation file, it has to be kept until stream_close()
+\param *variables_database - a pointer to the name of the variable file
+\param *data_database - a pointer to the name of the data file, it has to be kept until stream_close()
+\param *error - a pointer to the details of an error to be filled or NULL
+*/
+int stream_open(stream **result, const char *observations_database, const char *variables_database, const char *data_database, aoimo_error *error);
+
+/**
+A function that takes 5 parameters and returns an error code of the second pass of a streamed ranking, which computes the mean values of observations and passes the ranking of the standardized sum method to a function from the best to the worst position.
+Blocks of observations are scored by reading the values of every variable from the offsets found by stream_open(), every block is sorted and written as a run of a temporary file and the runs are merged (in several rounds if there are many of them). Positions are equal to the ones of compute_ranking() except observations with different mean values and equal index values.
+\param *ranking - a pointer to a streamed ranking after stream_open()
+\param top - an integer number of the best positions of the ranking, 0 for all
+\param emit - a function called for every position of the ranking, it gets the context, the position from 0, the index value, the observation ID and the name of the observation (the names are split into lines like by string_table_split() and are not limited in length)
+\param *context - a pointer passed to the function
+\param *error - a pointer to the details of an error to be filled or NULL
+*/
+int stream_rank(stream *ranking, int top, void (*emit)(void *context, int position, double index, int id, const char *name), void *context, aoimo_error *error);
+
+/**
+A function that takes a parameter and releases a streamed ranking.
+\param *ranking - a pointer to a streamed ranking
+*/
+void stream_close(stream *ranking);
+
+#endif